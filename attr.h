@@ -0,0 +1,144 @@
+/**
+ * Character attribute plane for the text-mode programs.
+ *
+ * vram_attr[y][x] holds the attribute of vram[y][x]: foreground level
+ * (white or gray), inverse, blink and double width / height.  The scanline
+ * kernel applies it to the pixel levels of the RAM font (fontgen -m 2bpp
+ * -r) in the same number of steps for any attribute, so a line keeps its
+ * timing:
+ *
+ *   const uint16_t *rows[ATTR_ROWS] = ATTR_LINE_ROWS(text_font, cline);
+ *   const attr_style *styles = attr_styles;
+ *   ...
+ *   unsigned char c = text[x];
+ *   const attr_style *s = &styles[attr[x]];
+ *   uint32_t pix = ATTR_PIX(rows, s, c);
+ *
+ * Each attribute has a style of two tables (blink on and off phases); the
+ * foreground mask of a glyph row (pix & 0x5555, bit 0 of level 3) becomes
+ * m * (fg - bg) + 0x5555 * bg.  attr_vsync(), called once a frame by the
+ * video interrupt, counts frames and switches the phase every
+ * ATTR_BLINK_FRAMES, so blinking costs the game loop nothing.
+ *
+ * Double width puts the left and right halves of a glyph, doubled, in two
+ * cells (ATTR_DW and ATTR_DW | ATTR_RIGHT); double height the upper and
+ * lower halves in two rows (ATTR_DH and ATTR_DH | ATTR_LOWER).
+ * attr_strings() writes both.
+ *
+ * Include this file after the declaration of vram (needs VRAM_W and VRAM_H)
+ * and call attr_init() once.
+ */
+
+#ifndef __ATTR__
+#define __ATTR__
+
+#include <stdint.h>
+
+#define ATTR_GRAY       0x01    // gray foreground
+#define ATTR_INVERSE    0x02    // background in the foreground level
+#define ATTR_BLINK      0x04    // foreground hidden every other blink phase
+#define ATTR_DW         0x08    // double width (left half)
+#define ATTR_RIGHT      0x10    // right half of double width
+#define ATTR_DH         0x20    // double height (upper half)
+#define ATTR_LOWER      0x40    // lower half of double height
+#define ATTR_NUM        0x80    // attributes 0..ATTR_NUM-1
+#define ATTR_ROWS       3       // glyph rows of a line: normal, upper and lower half
+#define ATTR_BLINK_FRAMES   30  // frames per blink phase
+#define ATTR_FG         3       // levels of the font (white on black)
+#define ATTR_BG         2
+#define ATTR_K          0x5555  // bit 0 of the level of 8 pixels
+#define ATTR_HALF_NUM   0x56    // bytes of 4 pixels at bits 0, 2, 4, 6 (0..0x55)
+
+// glyph rows of line cline of a character for the kernel
+#define ATTR_LINE_ROWS(font, cline) \
+    { (font)[cline], (font)[(cline) / 2], (font)[(cline) / 2 + CHAR_H / 2] }
+
+// foreground mask of a glyph row (pixels at bits 0, 2, .. 14) for a half
+#define ATTR_MASK(m, half)  (attr_half[half][0][(m) & 0xFF] | attr_half[half][1][(m) >> 8])
+// pixel levels of character c with style s (attr_styles[a])
+#define ATTR_PIX(rows, s, c) \
+    (ATTR_MASK((rows)[(s)->row][c] & ATTR_K, (s)->half) * (s)->mul + (s)->add)
+
+typedef struct {
+    int32_t mul;                // fg - bg
+    uint32_t add;               // ATTR_K * bg
+    uint8_t row;                // glyph row of the line (0 .. ATTR_ROWS - 1)
+    uint8_t half;               // 0: whole glyph, 1: left half doubled, 2: right half
+} attr_style;
+
+volatile unsigned char vram_attr[VRAM_H][VRAM_W];  // attributes of vram
+attr_style attr_style_tab[2][ATTR_NUM];     // styles of the blink phases
+const attr_style *volatile attr_styles = attr_style_tab[0];   // styles of this frame
+uint16_t attr_half[3][2][ATTR_HALF_NUM];              // masks of the low and high byte of each half
+volatile uint32_t attr_frame = 0;           // frame counter
+
+// to clear attributes
+void attr_clear( void ) {
+    for (int y = 0; y < VRAM_H; y++) {
+        for (int x = 0; x < VRAM_W; x++) {
+            vram_attr[y][x] = 0;
+        }
+    }
+}
+
+// to make the style tables
+void attr_init( void ) {
+    for (int b = 0; b < ATTR_HALF_NUM; b++) {
+        // b holds pixels at bits 0, 2, 4, 6: the same 4 pixels doubled
+        uint16_t d = 0;
+        for (int j = 0; j < 4; j++) {
+            if (b & (1 << (j * 2))) {
+                d |= 0x5 << (j * 4);
+            }
+        }
+        attr_half[0][0][b] = b;
+        attr_half[0][1][b] = b << 8;
+        attr_half[1][0][b] = d;
+        attr_half[1][1][b] = 0;
+        attr_half[2][0][b] = 0;
+        attr_half[2][1][b] = d;
+    }
+    for (int p = 0; p < 2; p++) {
+        for (int a = 0; a < ATTR_NUM; a++) {
+            int fg = (a & ATTR_GRAY) ? 1 : ATTR_FG, bg = ATTR_BG;     // gray is level 1
+            if (a & ATTR_INVERSE) {
+                int t = fg; fg = bg; bg = t;
+            }
+            if ((a & ATTR_BLINK) && p == 1) {
+                fg = bg;
+            }
+            attr_style *s = &attr_style_tab[p][a];
+            s->mul = fg - bg;
+            s->add = ATTR_K * bg;
+            s->row = (a & ATTR_DH) ? ((a & ATTR_LOWER) ? 2 : 1) : 0;
+            s->half = (a & ATTR_DW) ? ((a & ATTR_RIGHT) ? 2 : 1) : 0;
+        }
+    }
+    attr_styles = attr_style_tab[0];
+    attr_clear();
+}
+
+// to count a frame and switch the blink phase (from the video interrupt)
+void __not_in_flash_func(attr_vsync)( void ) {
+    attr_frame++;
+    attr_styles = attr_style_tab[(attr_frame / ATTR_BLINK_FRAMES) & 1];
+}
+
+// to write strings with an attribute into VRAM located at (x, y); double
+// width takes two cells a character and double height two rows
+void attr_strings( int x, int y, const char *mes, int a ) {
+    int w = (a & ATTR_DW) ? 2 : 1, h = (a & ATTR_DH) ? 2 : 1;
+    for (; *mes != '\0'; mes++, x += w) {
+        for (int i = 0; i < h; i++) {
+            for (int j = 0; j < w; j++) {
+                if (x + j < 0 || x + j >= VRAM_W || y + i < 0 || y + i >= VRAM_H) {
+                    continue;
+                }
+                vram[y + i][x + j] = *mes;
+                vram_attr[y + i][x + j] = a | (j ? ATTR_RIGHT : 0) | (i ? ATTR_LOWER : 0);
+            }
+        }
+    }
+}
+
+#endif
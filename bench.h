@@ -0,0 +1,114 @@
+/**
+ * Throughput benchmark hooks for the game programs.
+ *
+ * On the Pico all macros are empty.  In the host build (NTSC_HOST) they
+ * measure the time of the enclosed game functions and count main loop ticks;
+ * the program exits after NTSC_TICKS ticks (environment, default
+ * BENCH_TICKS) and prints ticks/second and per-function timings.  The
+ * default covers several scripted games of the busy-loop programs; programs
+ * ticking once a frame define BENCH_TICKS before including this file.
+ *
+ *   BENCH_BEGIN("move_entity");
+ *   move_entity(meteor, NMETEOR, p_meteor);
+ *   BENCH_END("move_entity");
+ */
+
+#ifndef __BENCH__
+#define __BENCH__
+
+#ifdef NTSC_HOST
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_MAX_FUNC  16      // max number of measured functions
+#ifndef BENCH_TICKS
+#define BENCH_TICKS     200000000   // default ticks to run
+#endif
+
+typedef struct {
+    const char *name;   // function name
+    long calls;         // number of calls
+    double total;       // total time [s]
+    double start;       // start time of the current call [s]
+} bench_func;
+
+bench_func bench_table[BENCH_MAX_FUNC];
+int bench_num = 0;
+long bench_ticks = 0;                   // main loop ticks
+long bench_max_ticks = 0;               // ticks to run
+double bench_start = 0;                 // start time of the run [s]
+
+// current time [s]
+double bench_now( void ) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// search (or register) a measured function
+bench_func *bench_find( const char *name ) {
+    for (int i = 0; i < bench_num; i++) {
+        if (bench_table[i].name == name || strcmp(bench_table[i].name, name) == 0) {
+            return &bench_table[i];
+        }
+    }
+    if (bench_num >= BENCH_MAX_FUNC) {
+        return &bench_table[BENCH_MAX_FUNC - 1];
+    }
+    bench_table[bench_num].name = name;
+    return &bench_table[bench_num++];
+}
+
+void bench_begin( const char *name ) {
+    bench_find(name)->start = bench_now();
+}
+
+void bench_end( const char *name ) {
+    bench_func *f = bench_find(name);
+    f->total += bench_now() - f->start;
+    f->calls++;
+}
+
+// print ticks/second and per-function timings
+void bench_report( void ) {
+    double elapsed = bench_now() - bench_start;
+    printf("ticks        %ld\n", bench_ticks);
+    printf("elapsed      %.3f s\n", elapsed);
+    printf("ticks/second %.0f\n", bench_ticks / elapsed);
+    printf("%-20s %10s %12s %10s\n", "function", "calls", "total[ms]", "ns/call");
+    for (int i = 0; i < bench_num; i++) {
+        bench_func *f = &bench_table[i];
+        printf("%-20s %10ld %12.3f %10.1f\n", f->name, f->calls, f->total * 1e3,
+            (f->calls > 0) ? f->total * 1e9 / f->calls : 0.0);
+    }
+}
+
+// count a main loop tick and exit when the run is over
+void bench_tick( void ) {
+    if (bench_ticks == 0) {
+        char *s = getenv("NTSC_TICKS");
+        bench_max_ticks = (s != NULL) ? atol(s) : BENCH_TICKS;
+        bench_start = bench_now();
+        atexit(bench_report);
+    }
+    if (++bench_ticks >= bench_max_ticks) {
+        exit(0);
+    }
+}
+
+#define BENCH_BEGIN(name)   bench_begin(name)
+#define BENCH_END(name)     bench_end(name)
+#define BENCH_TICK()        bench_tick()
+
+#else
+
+#define BENCH_BEGIN(name)
+#define BENCH_END(name)
+#define BENCH_TICK()
+
+#endif
+
+#endif
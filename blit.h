@@ -0,0 +1,157 @@
+/**
+ * Blitter for the packed graphic VRAM (gvram.h).
+ *
+ * All operations work on whole words of packed pixels: a source row is
+ * fetched 16 pixels at a time with a funnel shift of two words, and merged
+ * into the destination with a mask, so no operation loops over pixels.
+ *
+ *   blit_glyph(x, y, ascii_table[c], 8, 8, GV_WHITE, GV_BLACK);
+ *   blit_bitmap(x, y, sprite, sprite_mask, 16, 16);  // mask NULL = opaque
+ *   blit_copy(0, 8, 0, 0, GVRAM_W, 64);              // scroll down 8 lines
+ *   blit_fill(0, 0, GVRAM_W, 8, GV_BLACK);
+ *
+ * Bitmaps and masks are packed like gvram (2 bits per pixel, bit 1..0 =
+ * leftmost pixel) with (w + 15) / 16 words per row; a mask pixel is 3 where
+ * the bitmap is drawn and 0 where it is transparent.
+ *
+ * Copies of at least BLIT_DMA_MIN words per row between different lines
+ * with the same pixel phase, and fills of whole lines, go through the DMA
+ * channel of vdma.h while the CPU merges the edge words.
+ * The channel is claimed by vdma_init(); without it the CPU does all work.
+ *
+ * Include gvram.h before this file.
+ */
+
+#ifndef __BLIT__
+#define __BLIT__
+
+#include <string.h>
+#include "vdma.h"
+
+#ifndef BLIT_DMA_MIN
+#define BLIT_DMA_MIN    8       // min words per row to use DMA
+#endif
+#define BLIT_WORDS(w)   (((w) + GV_PPW - 1) / GV_PPW)  // words per row of a bitmap
+
+// 16 pixels from pixel p of a row of n words (p may be -15..-1: left part is 0)
+uint32_t blit_fetch( const uint32_t *row, int n, int p ) {
+    if (p < 0) {
+        return blit_fetch(row, n, 0) << (-p * 2);
+    }
+    int k = p / GV_PPW;
+    int s = (p % GV_PPW) * 2;
+    uint64_t v = row[k];
+    if (s != 0 && k + 1 < n) {
+        v |= (uint64_t)row[k + 1] << 32;
+    }
+    return (uint32_t)(v >> s);
+}
+
+// to merge w pixels of src (from pixel sx, n words) into drow from pixel dx
+// (mrow: transparency mask in the same layout as src, NULL = opaque)
+void blit_row( uint32_t *drow, int dx, const uint32_t *src, const uint32_t *mrow,
+               int n, int sx, int w ) {
+    int j0 = dx / GV_PPW;
+    int j1 = (dx + w - 1) / GV_PPW;
+    uint32_t head = ~0u << ((dx % GV_PPW) * 2);
+    uint32_t tail = ~0u >> ((GV_PPW - 1 - (dx + w - 1) % GV_PPW) * 2);
+    for (int j = j0; j <= j1; j++) {
+        int p = j * GV_PPW - dx + sx;
+        uint32_t mask = ~0u;
+        if (j == j0) mask &= head;
+        if (j == j1) mask &= tail;
+        if (mrow != NULL) {
+            mask &= blit_fetch(mrow, n, p);
+        }
+        GV_MERGE(&drow[j], mask, blit_fetch(src, n, p));
+    }
+}
+
+// to clip a w x h rectangle at (x, y) to the screen; moves (sx, sy) along
+bool blit_clip( int *x, int *y, int *w, int *h, int *sx, int *sy ) {
+    if (*x < 0) { *sx -= *x; *w += *x; *x = 0; }
+    if (*y < 0) { *sy -= *y; *h += *y; *y = 0; }
+    if (*x + *w > GVRAM_W) *w = GVRAM_W - *x;
+    if (*y + *h > GVRAM_H) *h = GVRAM_H - *y;
+    return (*w > 0) && (*h > 0);
+}
+
+// to draw a glyph of w (<= 16) x h pixels (a byte or half word per row,
+// bit 0 = leftmost) in fg on bg (GV_NONE = transparent)
+void blit_glyph( int x, int y, const unsigned char *rows, int w, int h, int fg, int bg ) {
+    for (int i = 0; i < h; i++) {
+        gvram_put_bits(x, y + i, (w > 8) ? rows[i * 2] | (rows[i * 2 + 1] << 8) : rows[i],
+                       w, fg, bg);
+    }
+}
+
+// to draw a packed bitmap of w x h pixels with a transparency mask (NULL = opaque)
+void blit_bitmap( int x, int y, const uint32_t *bitmap, const uint32_t *mask, int w, int h ) {
+    int n = BLIT_WORDS(w);
+    int sx = 0, sy = 0;
+    if (!blit_clip(&x, &y, &w, &h, &sx, &sy)) {
+        return;
+    }
+    for (int i = 0; i < h; i++) {
+        blit_row(gvram[y + i], x, &bitmap[(sy + i) * n], (mask != NULL) ? &mask[(sy + i) * n] : NULL,
+                 n, sx, w);
+    }
+}
+
+// to copy a w x h rectangle from (sx, sy) to (dx, dy); rectangles may overlap
+void blit_copy( int dx, int dy, int sx, int sy, int w, int h ) {
+    uint32_t tmp[GVRAM_WORDS];
+    // clip source, then destination
+    if (!blit_clip(&sx, &sy, &w, &h, &dx, &dy) || !blit_clip(&dx, &dy, &w, &h, &sx, &sy)) {
+        return;
+    }
+    // copy rows bottom up when moving down, so that no source row is overwritten
+    int step = (dy > sy) ? -1 : 1;
+    int i = (dy > sy) ? h - 1 : 0;
+    // inner words of the rows, if source and destination have the same phase
+    int j0 = (dx + GV_PPW - 1) / GV_PPW;
+    int j1 = (dx + w) / GV_PPW;
+    int shift = (sx - dx) / GV_PPW;
+    bool dma = (vdma_ch >= 0) && ((sx - dx) % GV_PPW == 0) && (j1 - j0 >= BLIT_DMA_MIN)
+        && (dy != sy);
+    for (int k = 0; k < h; k++, i += step) {
+        uint32_t *drow = gvram[dy + i];
+        uint32_t *srow = gvram[sy + i];
+        if (dma) {
+            vdma_copy(&drow[j0], &srow[j0 + shift], (j1 - j0) * 4);
+            // edges while DMA copies the inner words
+            if (dx < j0 * GV_PPW) {
+                blit_row(drow, dx, srow, NULL, GVRAM_WORDS, sx, j0 * GV_PPW - dx);
+            }
+            if (dx + w > j1 * GV_PPW) {
+                blit_row(drow, j1 * GV_PPW, srow, NULL, GVRAM_WORDS, sx + j1 * GV_PPW - dx,
+                         dx + w - j1 * GV_PPW);
+            }
+        } else {
+            memcpy(tmp, srow, sizeof(tmp));
+            blit_row(drow, dx, tmp, NULL, GVRAM_WORDS, sx, w);
+        }
+    }
+    if (dma) {
+        vdma_wait();
+    }
+}
+
+// to fill a w x h rectangle at (x, y) with a colour
+void blit_fill( int x, int y, int w, int h, int col ) {
+    int sx = 0, sy = 0;
+    if (!blit_clip(&x, &y, &w, &h, &sx, &sy)) {
+        return;
+    }
+    // whole lines are contiguous: one DMA transfer
+    if (vdma_ch >= 0 && x == 0 && w == GVRAM_W && h * GVRAM_WORDS >= BLIT_DMA_MIN) {
+        vdma_fill32(gvram[y], GV_FILL(col), h * GVRAM_WORDS);
+        vdma_wait();
+        return;
+    }
+    for (int i = 0; i < h; i++) {
+        gvram_span(x, x + w - 1, y + i, col);
+    }
+}
+
+#endif
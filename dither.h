@@ -0,0 +1,123 @@
+/**
+ * Ordered and temporal dithering onto the resistor ladder DAC.
+ *
+ * Pixels are 4-bit shades (0 = black .. 15 = white, two pixels per byte,
+ * even pixel in the low nibble).  dither_init() computes the output
+ * voltage of every code of the ladder from its resistors, keeps the codes
+ * from black up in order of brightness, and maps each shade to a voltage
+ * between two of those levels.  The remainder is dithered in 8 steps: a 2x2
+ * ordered pattern gives 4 steps in space, and the half steps between them
+ * alternate every frame in a checkerboard (temporal dithering).
+ *
+ * Everything is precomputed into dither_lut[phase][byte]: a byte of two
+ * shades gives the two DAC codes (even pixel in the low DAC_BITS bits), so
+ * a scanline does one table lookup per two pixels:
+ *
+ *   const uint8_t *lut = dither_lut[DITHER_PHASE(y, frame)];
+ *   uint32_t pix = lut[line[i]];
+ *   LEVEL(pix & DAC_CODE_MASK);
+ *   LEVEL(pix >> DAC_BITS);
+ *
+ * The ladder is given by the same pin masks as LEVEL(): DAC_MASK (pins from
+ * DAC_SHIFT up) and DAC_OHMS, the resistor of each pin in that order.  The
+ * default is the 2-pin ladder of the programs (GPIO14 330 ohm, GPIO15 1k
+ * ohm: black, gray and white); a third pin (e.g. GPIO16 with 2.2k ohm)
+ * gives 6 levels from black.
+ */
+
+#ifndef __DITHER__
+#define __DITHER__
+
+#include <stdint.h>
+
+#ifndef DAC_MASK
+#define DAC_MASK    ((1 << 14) | (1 << 15))     // GPIO14 and GPIO15
+#define DAC_SHIFT   14
+#define DAC_OHMS    {330, 1000}
+#endif
+#define DAC_BITS        __builtin_popcount(DAC_MASK)
+#define DAC_CODE_MASK   ((1 << DAC_BITS) - 1)
+#define DAC_CODES_MAX   16          // max codes (4 pins)
+#define DAC_LOAD_OHMS   75          // input impedance of the monitor
+#define DAC_VDD_MV      3300
+#define DAC_BLACK_MV    150         // darkest code at or above this is black
+#define DAC_MIN_STEP_MV 20          // levels closer than this are merged
+#define DITHER_SHADES   16
+#define DITHER_STEPS    8           // dither steps between two levels (2x2 pattern x 2 frames)
+#define DITHER_PHASE(y, frame)  (((y) & 1) | (((frame) & 1) << 1))
+
+const uint32_t dac_ohms[] = DAC_OHMS;
+int dac_mv[DAC_CODES_MAX];          // output voltage of each code
+uint8_t dac_level[DAC_CODES_MAX];   // visible codes from black to white
+int dac_levels;                     // number of visible codes
+uint8_t dither_shade[DITHER_SHADES][DITHER_STEPS];  // code of a shade at each threshold
+uint8_t dither_lut[4][256];         // [phase][two shades] -> two codes
+
+// threshold index of pixel x at phase (line parity, frame parity):
+// 2x2 Bayer pattern, plus a half step alternating every frame
+const uint8_t dither_bayer[2][2] = { {0, 2}, {3, 1} };
+
+int dither_threshold( int phase, int x ) {
+    int y = phase & 1, f = (phase >> 1) & 1;
+    return dither_bayer[y][x & 1] * 2 + ((f ^ y ^ x) & 1);
+}
+
+// to compute the ladder levels and the dither table
+void dither_init( void ) {
+    int n = DAC_BITS;
+    // conductance of each pin [uS] and of the load
+    uint32_t g[DAC_CODES_MAX], gsum = 1000000 / DAC_LOAD_OHMS;
+    for (int i = 0; i < n; i++) {
+        g[i] = 1000000 / dac_ohms[i];
+        gsum += g[i];
+    }
+    for (int c = 0; c < (1 << n); c++) {
+        uint32_t gon = 0;
+        for (int i = 0; i < n; i++) {
+            if ((c >> i) & 1) gon += g[i];
+        }
+        dac_mv[c] = DAC_VDD_MV * gon / gsum;
+    }
+    // visible codes in order of voltage from black
+    dac_levels = 0;
+    int last = -1;
+    while (1) {
+        int best = -1;
+        for (int c = 0; c < (1 << n); c++) {
+            if (dac_mv[c] >= DAC_BLACK_MV && dac_mv[c] > last
+                && (best < 0 || dac_mv[c] < dac_mv[best])) {
+                best = c;
+            }
+        }
+        if (best < 0) break;
+        if (dac_levels == 0 || dac_mv[best] - last >= DAC_MIN_STEP_MV) {
+            dac_level[dac_levels++] = best;
+        }
+        last = dac_mv[best];
+    }
+    // each shade: a voltage between black and white, between two levels
+    int black = dac_mv[dac_level[0]], white = dac_mv[dac_level[dac_levels - 1]];
+    for (int s = 0; s < DITHER_SHADES; s++) {
+        int v = black + (white - black) * s / (DITHER_SHADES - 1);
+        int l = 0;
+        while (l < dac_levels - 2 && dac_mv[dac_level[l + 1]] <= v) {
+            l++;
+        }
+        int lo = dac_mv[dac_level[l]], hi = dac_mv[dac_level[l + 1]];
+        // steps of the remainder (rounded), 0..DITHER_STEPS
+        int q = ((v - lo) * DITHER_STEPS * 2 + (hi - lo)) / ((hi - lo) * 2);
+        for (int t = 0; t < DITHER_STEPS; t++) {
+            dither_shade[s][t] = dac_level[(q > t) ? l + 1 : l];
+        }
+    }
+    // two pixels per byte (even pixel in the low nibble)
+    for (int phase = 0; phase < 4; phase++) {
+        for (int b = 0; b < 256; b++) {
+            uint8_t c0 = dither_shade[b & 0xF][dither_threshold(phase, 0)];
+            uint8_t c1 = dither_shade[b >> 4][dither_threshold(phase, 1)];
+            dither_lut[phase][b] = c0 | (c1 << DAC_BITS);
+        }
+    }
+}
+
+#endif
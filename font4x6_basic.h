@@ -0,0 +1,118 @@
+/**
+ * 4x6 monochrome bitmap font for rendering
+ * Glyphs are 3x5 pixels with one blank column and row.
+ *
+ * Characters U+0020 - U+007F (basic latin) in 4x6 cells, bit 0 = leftmost
+ * pixel, the same layout as font8x8_basic.h.
+ *
+ * License: Public Domain
+ **/
+
+#ifndef __FONT4x6_BASIC__
+#define __FONT4x6_BASIC__
+
+#define FONT4X6_FIRST  0x20    // first character in the table
+#define FONT4X6_NUM    96      // numbers of characters
+#define FONT4X6_W      4       // width of character
+#define FONT4X6_H      6       // height of character
+
+const unsigned char font4x6[FONT4X6_NUM][FONT4X6_H] = {
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},   // U+0020 (space)
+    { 0x02, 0x02, 0x02, 0x00, 0x02, 0x00},   // U+0021 (!)
+    { 0x05, 0x05, 0x00, 0x00, 0x00, 0x00},   // U+0022 (")
+    { 0x05, 0x07, 0x05, 0x07, 0x05, 0x00},   // U+0023 (#)
+    { 0x06, 0x03, 0x02, 0x06, 0x03, 0x00},   // U+0024 ($)
+    { 0x01, 0x04, 0x02, 0x01, 0x04, 0x00},   // U+0025 (%)
+    { 0x02, 0x05, 0x02, 0x05, 0x06, 0x00},   // U+0026 (&)
+    { 0x02, 0x02, 0x00, 0x00, 0x00, 0x00},   // U+0027 (')
+    { 0x04, 0x02, 0x02, 0x02, 0x04, 0x00},   // U+0028 (()
+    { 0x01, 0x02, 0x02, 0x02, 0x01, 0x00},   // U+0029 ())
+    { 0x00, 0x05, 0x02, 0x05, 0x00, 0x00},   // U+002A (*)
+    { 0x00, 0x02, 0x07, 0x02, 0x00, 0x00},   // U+002B (+)
+    { 0x00, 0x00, 0x00, 0x02, 0x01, 0x00},   // U+002C (,)
+    { 0x00, 0x00, 0x07, 0x00, 0x00, 0x00},   // U+002D (-)
+    { 0x00, 0x00, 0x00, 0x00, 0x02, 0x00},   // U+002E (.)
+    { 0x04, 0x04, 0x02, 0x01, 0x01, 0x00},   // U+002F (/)
+    { 0x07, 0x05, 0x05, 0x05, 0x07, 0x00},   // U+0030 (0)
+    { 0x02, 0x03, 0x02, 0x02, 0x07, 0x00},   // U+0031 (1)
+    { 0x03, 0x04, 0x02, 0x01, 0x07, 0x00},   // U+0032 (2)
+    { 0x03, 0x04, 0x02, 0x04, 0x03, 0x00},   // U+0033 (3)
+    { 0x05, 0x05, 0x07, 0x04, 0x04, 0x00},   // U+0034 (4)
+    { 0x07, 0x01, 0x03, 0x04, 0x03, 0x00},   // U+0035 (5)
+    { 0x06, 0x01, 0x07, 0x05, 0x07, 0x00},   // U+0036 (6)
+    { 0x07, 0x04, 0x02, 0x02, 0x02, 0x00},   // U+0037 (7)
+    { 0x07, 0x05, 0x07, 0x05, 0x07, 0x00},   // U+0038 (8)
+    { 0x07, 0x05, 0x07, 0x04, 0x03, 0x00},   // U+0039 (9)
+    { 0x00, 0x02, 0x00, 0x02, 0x00, 0x00},   // U+003A (:)
+    { 0x00, 0x02, 0x00, 0x02, 0x01, 0x00},   // U+003B (;)
+    { 0x04, 0x02, 0x01, 0x02, 0x04, 0x00},   // U+003C (<)
+    { 0x00, 0x07, 0x00, 0x07, 0x00, 0x00},   // U+003D (=)
+    { 0x01, 0x02, 0x04, 0x02, 0x01, 0x00},   // U+003E (>)
+    { 0x03, 0x04, 0x02, 0x00, 0x02, 0x00},   // U+003F (?)
+    { 0x02, 0x05, 0x07, 0x01, 0x06, 0x00},   // U+0040 (@)
+    { 0x02, 0x05, 0x07, 0x05, 0x05, 0x00},   // U+0041 (A)
+    { 0x03, 0x05, 0x03, 0x05, 0x03, 0x00},   // U+0042 (B)
+    { 0x06, 0x01, 0x01, 0x01, 0x06, 0x00},   // U+0043 (C)
+    { 0x03, 0x05, 0x05, 0x05, 0x03, 0x00},   // U+0044 (D)
+    { 0x07, 0x01, 0x07, 0x01, 0x07, 0x00},   // U+0045 (E)
+    { 0x07, 0x01, 0x07, 0x01, 0x01, 0x00},   // U+0046 (F)
+    { 0x06, 0x01, 0x05, 0x05, 0x06, 0x00},   // U+0047 (G)
+    { 0x05, 0x05, 0x07, 0x05, 0x05, 0x00},   // U+0048 (H)
+    { 0x07, 0x02, 0x02, 0x02, 0x07, 0x00},   // U+0049 (I)
+    { 0x04, 0x04, 0x04, 0x05, 0x02, 0x00},   // U+004A (J)
+    { 0x05, 0x05, 0x03, 0x05, 0x05, 0x00},   // U+004B (K)
+    { 0x01, 0x01, 0x01, 0x01, 0x07, 0x00},   // U+004C (L)
+    { 0x05, 0x07, 0x07, 0x05, 0x05, 0x00},   // U+004D (M)
+    { 0x05, 0x07, 0x07, 0x07, 0x05, 0x00},   // U+004E (N)
+    { 0x02, 0x05, 0x05, 0x05, 0x02, 0x00},   // U+004F (O)
+    { 0x03, 0x05, 0x03, 0x01, 0x01, 0x00},   // U+0050 (P)
+    { 0x02, 0x05, 0x05, 0x07, 0x06, 0x00},   // U+0051 (Q)
+    { 0x03, 0x05, 0x07, 0x03, 0x05, 0x00},   // U+0052 (R)
+    { 0x06, 0x01, 0x02, 0x04, 0x03, 0x00},   // U+0053 (S)
+    { 0x07, 0x02, 0x02, 0x02, 0x02, 0x00},   // U+0054 (T)
+    { 0x05, 0x05, 0x05, 0x05, 0x06, 0x00},   // U+0055 (U)
+    { 0x05, 0x05, 0x05, 0x02, 0x02, 0x00},   // U+0056 (V)
+    { 0x05, 0x05, 0x07, 0x07, 0x05, 0x00},   // U+0057 (W)
+    { 0x05, 0x05, 0x02, 0x05, 0x05, 0x00},   // U+0058 (X)
+    { 0x05, 0x05, 0x02, 0x02, 0x02, 0x00},   // U+0059 (Y)
+    { 0x07, 0x04, 0x02, 0x01, 0x07, 0x00},   // U+005A (Z)
+    { 0x07, 0x01, 0x01, 0x01, 0x07, 0x00},   // U+005B ([)
+    { 0x00, 0x01, 0x02, 0x04, 0x00, 0x00},   // U+005C (\)
+    { 0x07, 0x04, 0x04, 0x04, 0x07, 0x00},   // U+005D (])
+    { 0x02, 0x05, 0x00, 0x00, 0x00, 0x00},   // U+005E (^)
+    { 0x00, 0x00, 0x00, 0x00, 0x07, 0x00},   // U+005F (_)
+    { 0x01, 0x02, 0x00, 0x00, 0x00, 0x00},   // U+0060 (`)
+    { 0x00, 0x03, 0x06, 0x05, 0x07, 0x00},   // U+0061 (a)
+    { 0x01, 0x03, 0x05, 0x05, 0x03, 0x00},   // U+0062 (b)
+    { 0x00, 0x06, 0x01, 0x01, 0x06, 0x00},   // U+0063 (c)
+    { 0x04, 0x06, 0x05, 0x05, 0x06, 0x00},   // U+0064 (d)
+    { 0x00, 0x06, 0x05, 0x03, 0x06, 0x00},   // U+0065 (e)
+    { 0x04, 0x02, 0x07, 0x02, 0x02, 0x00},   // U+0066 (f)
+    { 0x00, 0x06, 0x05, 0x07, 0x04, 0x00},   // U+0067 (g)
+    { 0x01, 0x03, 0x05, 0x05, 0x05, 0x00},   // U+0068 (h)
+    { 0x02, 0x00, 0x02, 0x02, 0x02, 0x00},   // U+0069 (i)
+    { 0x04, 0x00, 0x04, 0x05, 0x02, 0x00},   // U+006A (j)
+    { 0x01, 0x05, 0x03, 0x03, 0x05, 0x00},   // U+006B (k)
+    { 0x03, 0x02, 0x02, 0x02, 0x07, 0x00},   // U+006C (l)
+    { 0x00, 0x07, 0x07, 0x07, 0x05, 0x00},   // U+006D (m)
+    { 0x00, 0x03, 0x05, 0x05, 0x05, 0x00},   // U+006E (n)
+    { 0x00, 0x02, 0x05, 0x05, 0x02, 0x00},   // U+006F (o)
+    { 0x00, 0x03, 0x05, 0x03, 0x01, 0x00},   // U+0070 (p)
+    { 0x00, 0x06, 0x05, 0x06, 0x04, 0x00},   // U+0071 (q)
+    { 0x00, 0x06, 0x01, 0x01, 0x01, 0x00},   // U+0072 (r)
+    { 0x00, 0x06, 0x03, 0x06, 0x03, 0x00},   // U+0073 (s)
+    { 0x02, 0x07, 0x02, 0x02, 0x06, 0x00},   // U+0074 (t)
+    { 0x00, 0x05, 0x05, 0x05, 0x06, 0x00},   // U+0075 (u)
+    { 0x00, 0x05, 0x05, 0x02, 0x02, 0x00},   // U+0076 (v)
+    { 0x00, 0x05, 0x07, 0x07, 0x07, 0x00},   // U+0077 (w)
+    { 0x00, 0x05, 0x02, 0x02, 0x05, 0x00},   // U+0078 (x)
+    { 0x00, 0x05, 0x05, 0x06, 0x03, 0x00},   // U+0079 (y)
+    { 0x00, 0x07, 0x06, 0x03, 0x07, 0x00},   // U+007A (z)
+    { 0x06, 0x02, 0x03, 0x02, 0x06, 0x00},   // U+007B ({)
+    { 0x02, 0x02, 0x02, 0x02, 0x02, 0x00},   // U+007C (|)
+    { 0x03, 0x02, 0x06, 0x02, 0x03, 0x00},   // U+007D (})
+    { 0x00, 0x06, 0x03, 0x00, 0x00, 0x00},   // U+007E (~)
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}    // U+007F
+};
+
+#endif
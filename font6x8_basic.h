@@ -0,0 +1,118 @@
+/**
+ * 6x8 monochrome bitmap font for rendering
+ * Glyphs are 5x7 pixels with one blank column and row.
+ *
+ * Characters U+0020 - U+007F (basic latin) in 6x8 cells, bit 0 = leftmost
+ * pixel, the same layout as font8x8_basic.h.
+ *
+ * License: Public Domain
+ **/
+
+#ifndef __FONT6x8_BASIC__
+#define __FONT6x8_BASIC__
+
+#define FONT6X8_FIRST  0x20    // first character in the table
+#define FONT6X8_NUM    96      // numbers of characters
+#define FONT6X8_W      6       // width of character
+#define FONT6X8_H      8       // height of character
+
+const unsigned char font6x8[FONT6X8_NUM][FONT6X8_H] = {
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},   // U+0020 (space)
+    { 0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04, 0x00},   // U+0021 (!)
+    { 0x0A, 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00},   // U+0022 (")
+    { 0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A, 0x00},   // U+0023 (#)
+    { 0x04, 0x1E, 0x05, 0x0E, 0x14, 0x0F, 0x04, 0x00},   // U+0024 ($)
+    { 0x03, 0x13, 0x08, 0x04, 0x02, 0x19, 0x18, 0x00},   // U+0025 (%)
+    { 0x06, 0x09, 0x05, 0x02, 0x15, 0x09, 0x16, 0x00},   // U+0026 (&)
+    { 0x06, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00},   // U+0027 (')
+    { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08, 0x00},   // U+0028 (()
+    { 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02, 0x00},   // U+0029 ())
+    { 0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00, 0x00},   // U+002A (*)
+    { 0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00, 0x00},   // U+002B (+)
+    { 0x00, 0x00, 0x00, 0x00, 0x06, 0x04, 0x02, 0x00},   // U+002C (,)
+    { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00, 0x00},   // U+002D (-)
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x06, 0x06, 0x00},   // U+002E (.)
+    { 0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00, 0x00},   // U+002F (/)
+    { 0x0E, 0x11, 0x19, 0x15, 0x13, 0x11, 0x0E, 0x00},   // U+0030 (0)
+    { 0x04, 0x06, 0x04, 0x04, 0x04, 0x04, 0x0E, 0x00},   // U+0031 (1)
+    { 0x0E, 0x11, 0x10, 0x08, 0x04, 0x02, 0x1F, 0x00},   // U+0032 (2)
+    { 0x1F, 0x08, 0x04, 0x08, 0x10, 0x11, 0x0E, 0x00},   // U+0033 (3)
+    { 0x08, 0x0C, 0x0A, 0x09, 0x1F, 0x08, 0x08, 0x00},   // U+0034 (4)
+    { 0x1F, 0x01, 0x0F, 0x10, 0x10, 0x11, 0x0E, 0x00},   // U+0035 (5)
+    { 0x0C, 0x02, 0x01, 0x0F, 0x11, 0x11, 0x0E, 0x00},   // U+0036 (6)
+    { 0x1F, 0x10, 0x08, 0x04, 0x02, 0x02, 0x02, 0x00},   // U+0037 (7)
+    { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E, 0x00},   // U+0038 (8)
+    { 0x0E, 0x11, 0x11, 0x1E, 0x10, 0x08, 0x06, 0x00},   // U+0039 (9)
+    { 0x00, 0x06, 0x06, 0x00, 0x06, 0x06, 0x00, 0x00},   // U+003A (:)
+    { 0x00, 0x06, 0x06, 0x00, 0x06, 0x04, 0x02, 0x00},   // U+003B (;)
+    { 0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08, 0x00},   // U+003C (<)
+    { 0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00, 0x00},   // U+003D (=)
+    { 0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02, 0x00},   // U+003E (>)
+    { 0x0E, 0x11, 0x10, 0x08, 0x04, 0x00, 0x04, 0x00},   // U+003F (?)
+    { 0x0E, 0x11, 0x10, 0x16, 0x15, 0x15, 0x0E, 0x00},   // U+0040 (@)
+    { 0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11, 0x00},   // U+0041 (A)
+    { 0x0F, 0x11, 0x11, 0x0F, 0x11, 0x11, 0x0F, 0x00},   // U+0042 (B)
+    { 0x0E, 0x11, 0x01, 0x01, 0x01, 0x11, 0x0E, 0x00},   // U+0043 (C)
+    { 0x07, 0x09, 0x11, 0x11, 0x11, 0x09, 0x07, 0x00},   // U+0044 (D)
+    { 0x1F, 0x01, 0x01, 0x0F, 0x01, 0x01, 0x1F, 0x00},   // U+0045 (E)
+    { 0x1F, 0x01, 0x01, 0x0F, 0x01, 0x01, 0x01, 0x00},   // U+0046 (F)
+    { 0x0E, 0x11, 0x01, 0x1D, 0x11, 0x11, 0x1E, 0x00},   // U+0047 (G)
+    { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11, 0x00},   // U+0048 (H)
+    { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E, 0x00},   // U+0049 (I)
+    { 0x1C, 0x08, 0x08, 0x08, 0x08, 0x09, 0x06, 0x00},   // U+004A (J)
+    { 0x11, 0x09, 0x05, 0x03, 0x05, 0x09, 0x11, 0x00},   // U+004B (K)
+    { 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x1F, 0x00},   // U+004C (L)
+    { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11, 0x00},   // U+004D (M)
+    { 0x11, 0x11, 0x13, 0x15, 0x19, 0x11, 0x11, 0x00},   // U+004E (N)
+    { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E, 0x00},   // U+004F (O)
+    { 0x0F, 0x11, 0x11, 0x0F, 0x01, 0x01, 0x01, 0x00},   // U+0050 (P)
+    { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x09, 0x16, 0x00},   // U+0051 (Q)
+    { 0x0F, 0x11, 0x11, 0x0F, 0x05, 0x09, 0x11, 0x00},   // U+0052 (R)
+    { 0x1E, 0x01, 0x01, 0x0E, 0x10, 0x10, 0x0F, 0x00},   // U+0053 (S)
+    { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x00},   // U+0054 (T)
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E, 0x00},   // U+0055 (U)
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04, 0x00},   // U+0056 (V)
+    { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A, 0x00},   // U+0057 (W)
+    { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11, 0x00},   // U+0058 (X)
+    { 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04, 0x00},   // U+0059 (Y)
+    { 0x1F, 0x10, 0x08, 0x04, 0x02, 0x01, 0x1F, 0x00},   // U+005A (Z)
+    { 0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E, 0x00},   // U+005B ([)
+    { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00, 0x00},   // U+005C (\)
+    { 0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E, 0x00},   // U+005D (])
+    { 0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00},   // U+005E (^)
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F, 0x00},   // U+005F (_)
+    { 0x02, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00},   // U+0060 (`)
+    { 0x00, 0x00, 0x0E, 0x10, 0x1E, 0x11, 0x1E, 0x00},   // U+0061 (a)
+    { 0x01, 0x01, 0x0D, 0x13, 0x11, 0x11, 0x0F, 0x00},   // U+0062 (b)
+    { 0x00, 0x00, 0x0E, 0x01, 0x01, 0x11, 0x0E, 0x00},   // U+0063 (c)
+    { 0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x1E, 0x00},   // U+0064 (d)
+    { 0x00, 0x00, 0x0E, 0x11, 0x1F, 0x01, 0x0E, 0x00},   // U+0065 (e)
+    { 0x0C, 0x12, 0x02, 0x07, 0x02, 0x02, 0x02, 0x00},   // U+0066 (f)
+    { 0x00, 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x0E, 0x00},   // U+0067 (g)
+    { 0x01, 0x01, 0x0D, 0x13, 0x11, 0x11, 0x11, 0x00},   // U+0068 (h)
+    { 0x04, 0x00, 0x06, 0x04, 0x04, 0x04, 0x0E, 0x00},   // U+0069 (i)
+    { 0x08, 0x00, 0x0C, 0x08, 0x08, 0x09, 0x06, 0x00},   // U+006A (j)
+    { 0x01, 0x01, 0x09, 0x05, 0x03, 0x05, 0x09, 0x00},   // U+006B (k)
+    { 0x06, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E, 0x00},   // U+006C (l)
+    { 0x00, 0x00, 0x0B, 0x15, 0x15, 0x11, 0x11, 0x00},   // U+006D (m)
+    { 0x00, 0x00, 0x0D, 0x13, 0x11, 0x11, 0x11, 0x00},   // U+006E (n)
+    { 0x00, 0x00, 0x0E, 0x11, 0x11, 0x11, 0x0E, 0x00},   // U+006F (o)
+    { 0x00, 0x00, 0x0F, 0x11, 0x0F, 0x01, 0x01, 0x00},   // U+0070 (p)
+    { 0x00, 0x00, 0x16, 0x19, 0x1E, 0x10, 0x10, 0x00},   // U+0071 (q)
+    { 0x00, 0x00, 0x0D, 0x13, 0x01, 0x01, 0x01, 0x00},   // U+0072 (r)
+    { 0x00, 0x00, 0x0E, 0x01, 0x0E, 0x10, 0x0F, 0x00},   // U+0073 (s)
+    { 0x02, 0x02, 0x07, 0x02, 0x02, 0x12, 0x0C, 0x00},   // U+0074 (t)
+    { 0x00, 0x00, 0x11, 0x11, 0x11, 0x19, 0x16, 0x00},   // U+0075 (u)
+    { 0x00, 0x00, 0x11, 0x11, 0x11, 0x0A, 0x04, 0x00},   // U+0076 (v)
+    { 0x00, 0x00, 0x11, 0x11, 0x15, 0x15, 0x0A, 0x00},   // U+0077 (w)
+    { 0x00, 0x00, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x00},   // U+0078 (x)
+    { 0x00, 0x00, 0x11, 0x11, 0x1E, 0x10, 0x0E, 0x00},   // U+0079 (y)
+    { 0x00, 0x00, 0x1F, 0x08, 0x04, 0x02, 0x1F, 0x00},   // U+007A (z)
+    { 0x08, 0x04, 0x04, 0x02, 0x04, 0x04, 0x08, 0x00},   // U+007B ({)
+    { 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x00},   // U+007C (|)
+    { 0x02, 0x04, 0x04, 0x08, 0x04, 0x04, 0x02, 0x00},   // U+007D (})
+    { 0x00, 0x00, 0x02, 0x15, 0x08, 0x00, 0x00, 0x00},   // U+007E (~)
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}    // U+007F
+};
+
+#endif
@@ -20,6 +20,9 @@
 /**
  * modified by Pa@ART on Feb.28, 2021
  *   for NTSC signal generator
+ *
+ * ascii_table is const and stays in flash; the scanlines read line-major
+ * tables in RAM generated from it by tools/fontgen.
  **/
 
 // Constant: font8x8_basic
@@ -31,7 +34,7 @@
 #define CHAR_W          8       // width of character
 #define CHAR_H          8       // height of character
 
-volatile unsigned char ascii_table[ASCII_CHAR_NUM][CHAR_H] = {
+const unsigned char ascii_table[ASCII_CHAR_NUM][CHAR_H] = {
     { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},   // U+0000 (nul)
     { 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55},   // U+0001 hashed box
     { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF},   // U+0002 black box
@@ -0,0 +1,97 @@
+/**
+ * Fonts for graphic mode: 4x6, 6x8, 8x8 and 8x16 cells, fixed or
+ * proportional width, drawn into the packed graphic VRAM (gvram.h).
+ *
+ * A glyph row is written as one span of packed pixels (gvram_put_bits()),
+ * i.e. one or two word updates per row instead of one store per pixel.
+ *
+ *   gfont_strings(0, 0, &font_4x6, "SCORE 100", GV_WHITE, GV_BLACK);
+ *
+ * Include gvram.h before this file.
+ */
+
+#ifndef __GFONT__
+#define __GFONT__
+
+#include <string.h>
+#include "font8x8_basic.h"
+#include "font4x6_basic.h"
+#include "font6x8_basic.h"
+#include "font8x16_basic.h"
+
+typedef struct {
+    const unsigned char *rows;  // rows of characters (h bytes each, bit 0 = leftmost)
+    const unsigned char *width; // advance width of each character, NULL if fixed
+    unsigned char w;            // width of character cell
+    unsigned char h;            // height of character cell
+    unsigned char first;        // first character in rows
+    unsigned char num;          // numbers of characters in rows
+} gfont;
+
+const gfont font_4x6 = { font4x6[0], NULL, FONT4X6_W, FONT4X6_H, FONT4X6_FIRST, FONT4X6_NUM };
+const gfont font_6x8 = { font6x8[0], NULL, FONT6X8_W, FONT6X8_H, FONT6X8_FIRST, FONT6X8_NUM };
+const gfont font_8x8 = { ascii_table[0], NULL, CHAR_W, CHAR_H, 0, ASCII_CHAR_NUM };
+const gfont font_8x16 = { font8x16[0], NULL, FONT8X16_W, FONT8X16_H, FONT8X16_FIRST, FONT8X16_NUM };
+
+// to make a proportional version of src: each character advances by its
+// inked width plus one blank column (space = half cell); widths[src->num]
+void gfont_proportional( gfont *dst, const gfont *src, unsigned char *widths ) {
+    for (int c = 0; c < src->num; c++) {
+        unsigned char used = 0;
+        for (int i = 0; i < src->h; i++) {
+            used |= src->rows[c * src->h + i];
+        }
+        int w = 0;
+        while (used != 0) {
+            used >>= 1;
+            w++;
+        }
+        widths[c] = (w == 0) ? src->w / 2 : ((w + 1 < src->w) ? w + 1 : src->w);
+    }
+    *dst = *src;
+    dst->width = widths;
+}
+
+// advance width of a character
+int gfont_char_width( const gfont *f, unsigned char c ) {
+    if (f->width == NULL || c < f->first || c >= f->first + f->num) {
+        return f->w;
+    }
+    return f->width[c - f->first];
+}
+
+// width of strings in pixels
+int gfont_text_width( const gfont *f, const char *mes ) {
+    int w = 0;
+    for (; *mes != '\0'; mes++) {
+        w += gfont_char_width(f, (unsigned char)*mes);
+    }
+    return w;
+}
+
+// put a character at (x, y) (bg = GV_NONE for transparent); returns advance width
+int gfont_put_char( int x, int y, const gfont *f, unsigned char c, int fg, int bg ) {
+    int w = gfont_char_width(f, c);
+    // characters out of the table are blank
+    if (c < f->first || c >= f->first + f->num) {
+        for (int i = 0; i < f->h; i++) {
+            gvram_put_bits(x, y + i, 0, w, fg, bg);
+        }
+        return w;
+    }
+    const unsigned char *rows = &f->rows[(c - f->first) * f->h];
+    for (int i = 0; i < f->h; i++) {
+        gvram_put_bits(x, y + i, rows[i], w, fg, bg);
+    }
+    return w;
+}
+
+// put strings at (x, y); returns x after the last character
+int gfont_strings( int x, int y, const gfont *f, const char *mes, int fg, int bg ) {
+    for (; *mes != '\0' && x < GVRAM_W; mes++) {
+        x += gfont_put_char(x, y, f, (unsigned char)*mes, fg, bg);
+    }
+    return x;
+}
+
+#endif
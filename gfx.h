@@ -0,0 +1,193 @@
+/**
+ * Graphic primitives for the packed graphic VRAM (gvram.h) without FPU.
+ *
+ * Angles are GFX_ANGLES (1024) steps per turn and gfx_sin()/gfx_cos()
+ * return Q15 values (-32767..32767) from a quarter-wave table.  Lines use
+ * Bresenham's algorithm stepping a word pointer and a bit shift, circles
+ * the midpoint algorithm, and filled shapes are drawn as horizontal spans
+ * (gvram_span()), so a whole word is written at a time where possible.
+ *
+ *   int y = cy + GFX_MUL(gfx_sin(a), r);     // r * sin(a)
+ *   gfx_line(x0, y0, x1, y1, GV_WHITE);
+ *   gfx_fill_circle(128, 96, 20, GV_GRAY);
+ *
+ * Include gvram.h before this file.
+ */
+
+#ifndef __GFX__
+#define __GFX__
+
+#define GFX_ANGLES      1024                // angle steps per turn
+#define GFX_QUARTER     (GFX_ANGLES / 4)
+#define GFX_ONE         32767               // 1.0 in Q15
+#define GFX_MUL(q, v)   (((q) * (v)) >> 15) // Q15 value * integer
+
+// sin of 0..GFX_QUARTER in Q15
+const int16_t gfx_sin_table[GFX_QUARTER + 1] = {
+        0,   201,   402,   603,   804,  1005,  1206,  1407,
+     1608,  1809,  2009,  2210,  2411,  2611,  2811,  3012,
+     3212,  3412,  3612,  3812,  4011,  4211,  4410,  4609,
+     4808,  5007,  5205,  5404,  5602,  5800,  5998,  6195,
+     6393,  6590,  6787,  6983,  7180,  7376,  7571,  7767,
+     7962,  8157,  8351,  8546,  8740,  8933,  9127,  9319,
+     9512,  9704,  9896, 10088, 10279, 10469, 10660, 10850,
+    11039, 11228, 11417, 11605, 11793, 11980, 12167, 12354,
+    12540, 12725, 12910, 13095, 13279, 13463, 13646, 13828,
+    14010, 14192, 14373, 14553, 14733, 14912, 15091, 15269,
+    15447, 15624, 15800, 15976, 16151, 16326, 16500, 16673,
+    16846, 17018, 17190, 17361, 17531, 17700, 17869, 18037,
+    18205, 18372, 18538, 18703, 18868, 19032, 19195, 19358,
+    19520, 19681, 19841, 20001, 20160, 20318, 20475, 20632,
+    20788, 20943, 21097, 21251, 21403, 21555, 21706, 21856,
+    22006, 22154, 22302, 22449, 22595, 22740, 22884, 23028,
+    23170, 23312, 23453, 23593, 23732, 23870, 24008, 24144,
+    24279, 24414, 24548, 24680, 24812, 24943, 25073, 25202,
+    25330, 25457, 25583, 25708, 25833, 25956, 26078, 26199,
+    26320, 26439, 26557, 26674, 26791, 26906, 27020, 27133,
+    27246, 27357, 27467, 27576, 27684, 27791, 27897, 28002,
+    28106, 28209, 28311, 28411, 28511, 28610, 28707, 28803,
+    28899, 28993, 29086, 29178, 29269, 29359, 29448, 29535,
+    29622, 29707, 29792, 29875, 29957, 30038, 30118, 30196,
+    30274, 30350, 30425, 30499, 30572, 30644, 30715, 30784,
+    30853, 30920, 30986, 31050, 31114, 31177, 31238, 31298,
+    31357, 31415, 31471, 31527, 31581, 31634, 31686, 31737,
+    31786, 31834, 31881, 31927, 31972, 32015, 32058, 32099,
+    32138, 32177, 32214, 32251, 32286, 32319, 32352, 32383,
+    32413, 32442, 32470, 32496, 32522, 32546, 32568, 32590,
+    32610, 32629, 32647, 32664, 32679, 32693, 32706, 32718,
+    32729, 32738, 32746, 32753, 32758, 32762, 32766, 32767,
+    32767
+};
+
+// sin(a) in Q15 (a in GFX_ANGLES steps per turn, any integer)
+int gfx_sin( int a ) {
+    a &= GFX_ANGLES - 1;
+    if (a < GFX_QUARTER) {
+        return gfx_sin_table[a];
+    } else if (a < GFX_QUARTER * 2) {
+        return gfx_sin_table[GFX_QUARTER * 2 - a];
+    } else if (a < GFX_QUARTER * 3) {
+        return -gfx_sin_table[a - GFX_QUARTER * 2];
+    }
+    return -gfx_sin_table[GFX_ANGLES - a];
+}
+
+// cos(a) in Q15
+int gfx_cos( int a ) {
+    return gfx_sin(a + GFX_QUARTER);
+}
+
+// to draw a line from (x0, y0) to (x1, y1)
+void gfx_line( int x0, int y0, int x1, int y1, int col ) {
+    // horizontal line is a span
+    if (y0 == y1) {
+        gvram_span(x0, x1, y0, col);
+        return;
+    }
+    int dx = (x1 > x0) ? x1 - x0 : x0 - x1;
+    int dy = (y1 > y0) ? y0 - y1 : y1 - y0;     // -|y1 - y0|
+    int sx = (x1 > x0) ? 1 : -1;
+    int sy = (y1 > y0) ? 1 : -1;
+    int err = dx + dy;
+    // lines partly out of the screen are clipped per pixel
+    if ((x0 | y0 | x1 | y1) < 0 || x0 >= GVRAM_W || x1 >= GVRAM_W
+        || y0 >= GVRAM_H || y1 >= GVRAM_H) {
+        while (1) {
+            gvram_pset(x0, y0, col);
+            if (x0 == x1 && y0 == y1) break;
+            int e2 = err * 2;
+            if (e2 >= dy) { err += dy; x0 += sx; }
+            if (e2 <= dx) { err += dx; y0 += sy; }
+        }
+        return;
+    }
+    // else step the word pointer and the shift of the pixel
+    uint32_t *p = &gvram[y0][x0 / GV_PPW];
+    int s = (x0 % GV_PPW) * 2;
+    int n = ((dx > -dy) ? dx : -dy) + 1;
+    uint32_t v = GV_FILL(col);
+    for (; n > 0; n--) {
+        GV_MERGE(p, 3u << s, v);
+        int e2 = err * 2;
+        if (e2 >= dy) {
+            err += dy;
+            s += sx * 2;
+            if (s < 0) { s += GV_PPW * 2; p--; }
+            else if (s >= GV_PPW * 2) { s -= GV_PPW * 2; p++; }
+        }
+        if (e2 <= dx) {
+            err += dx;
+            p += sy * GVRAM_WORDS;
+        }
+    }
+}
+
+// to fill a rectangle of w x h pixels at (x, y)
+void gfx_fill_rect( int x, int y, int w, int h, int col ) {
+    if (w <= 0) {
+        return;
+    }
+    for (int i = 0; i < h; i++) {
+        gvram_span(x, x + w - 1, y + i, col);
+    }
+}
+
+// to draw an outline of a rectangle of w x h pixels at (x, y)
+void gfx_rect( int x, int y, int w, int h, int col ) {
+    if (w <= 0 || h <= 0) {
+        return;
+    }
+    gvram_span(x, x + w - 1, y, col);
+    gvram_span(x, x + w - 1, y + h - 1, col);
+    gfx_line(x, y, x, y + h - 1, col);
+    gfx_line(x + w - 1, y, x + w - 1, y + h - 1, col);
+}
+
+// to draw a circle of radius r centred at (cx, cy)
+void gfx_circle( int cx, int cy, int r, int col ) {
+    int x = r, y = 0, err = 1 - r;
+    while (x >= y) {
+        gvram_pset(cx + x, cy + y, col); gvram_pset(cx - x, cy + y, col);
+        gvram_pset(cx + x, cy - y, col); gvram_pset(cx - x, cy - y, col);
+        gvram_pset(cx + y, cy + x, col); gvram_pset(cx - y, cy + x, col);
+        gvram_pset(cx + y, cy - x, col); gvram_pset(cx - y, cy - x, col);
+        y++;
+        if (err < 0) {
+            err += 2 * y + 1;
+        } else {
+            x--;
+            err += 2 * (y - x) + 1;
+        }
+    }
+}
+
+// to fill a circle of radius r centred at (cx, cy) with spans
+void gfx_fill_circle( int cx, int cy, int r, int col ) {
+    int x = r, y = 0, err = 1 - r;
+    while (x >= y) {
+        gvram_span(cx - x, cx + x, cy + y, col);
+        gvram_span(cx - x, cx + x, cy - y, col);
+        // spans at cy +- x only when x changes (each line once)
+        if (err >= 0 && x != y) {
+            gvram_span(cx - y, cx + y, cy + x, col);
+            gvram_span(cx - y, cx + y, cy - x, col);
+        }
+        y++;
+        if (err < 0) {
+            err += 2 * y + 1;
+        } else {
+            x--;
+            err += 2 * (y - x) + 1;
+        }
+    }
+}
+
+// to draw a closed polygon of n vertices (x[i], y[i])
+void gfx_polygon( const int *x, const int *y, int n, int col ) {
+    for (int i = 0; i < n; i++) {
+        int j = (i + 1 < n) ? i + 1 : 0;
+        gfx_line(x[i], y[i], x[j], y[j], col);
+    }
+}
+
+#endif
@@ -0,0 +1,131 @@
+/**
+ * Packed graphic VRAM for the NTSC programs.
+ *
+ * 2 bits per pixel, 16 pixels per word, row-major: pixel (x, y) is in
+ * gvram[y][x / 16], bits (x % 16) * 2 + 1..0.  Pixel values are the level
+ * codes put on GPIO15:GPIO14 (GV_BLACK, GV_GRAY, GV_WHITE), so a scanline
+ * shifts the words out as they are and a 256x192 screen takes 12KB.
+ *
+ * Define GVRAM_W (multiple of 16) and GVRAM_H before including this file
+ * and call gvram_init() once.  gvram_clear() fills by DMA when vdma_init()
+ * has claimed a channel (vdma.h), by the CPU otherwise.
+ */
+
+#ifndef __GVRAM__
+#define __GVRAM__
+
+#include <stdint.h>
+#include "vdma.h"     // clear by DMA
+
+#define GV_SYNC     0       // level code of sync (never drawn)
+#define GV_GRAY     1       // GPIO14='H' and GPIO15='L'
+#define GV_BLACK    2       // GPIO14='L' and GPIO15='H'
+#define GV_WHITE    3       // GPIO14='H' and GPIO15='H'
+#define GV_NONE     (-1)    // transparent background
+#define GV_PPW      16      // pixels per word
+#define GVRAM_WORDS (GVRAM_W / GV_PPW)          // words per line
+#define GV_FILL(col)    ((uint32_t)(col) * 0x55555555u) // word filled with col
+
+uint32_t gvram[GVRAM_H][GVRAM_WORDS];   // graphic VRAM
+uint16_t gv_expand[256];    // 8 pixel bits -> 2-bit mask per pixel
+
+// expand up to 16 pixel bits into a mask with 2 bits per pixel
+#define GV_MASK(bits)   (gv_expand[(bits) & 0xFF] | ((uint32_t)gv_expand[((bits) >> 8) & 0xFF] << 16))
+
+// to clear graphic VRAM with a colour (by DMA after vdma_init())
+void gvram_clear( int col ) {
+    vdma_fill32(gvram[0], GV_FILL(col), GVRAM_H * GVRAM_WORDS);
+    vdma_wait();
+}
+
+// to initialize expansion table and clear graphic VRAM to black
+void gvram_init( void ) {
+    for (int b = 0; b < 256; b++) {
+        uint16_t m = 0;
+        for (int i = 0; i < 8; i++) {
+            if ((b & (1 << i)) != 0) m |= 3 << (i * 2);
+        }
+        gv_expand[b] = m;
+    }
+    gvram_clear(GV_BLACK);
+}
+
+// to write a pixel located at (x, y)
+void gvram_pset( int x, int y, int col ) {
+    if ((x < 0) || (x >= GVRAM_W) || (y < 0) || (y >= GVRAM_H)) {
+        return;
+    }
+    int s = (x % GV_PPW) * 2;
+    gvram[y][x / GV_PPW] = (gvram[y][x / GV_PPW] & ~(3u << s)) | ((uint32_t)col << s);
+}
+
+// to read a pixel located at (x, y)
+int gvram_pget( int x, int y ) {
+    if ((x < 0) || (x >= GVRAM_W) || (y < 0) || (y >= GVRAM_H)) {
+        return GV_BLACK;
+    }
+    return (gvram[y][x / GV_PPW] >> ((x % GV_PPW) * 2)) & 3;
+}
+
+// to write masked bits into the word at pixel x (x % 16 == 0) of line y
+#define GV_MERGE(p, mask, value)    (*(p) = (*(p) & ~(mask)) | ((value) & (mask)))
+
+// to fill a horizontal span x0..x1 (inclusive) of line y, a word at a time
+void gvram_span( int x0, int x1, int y, int col ) {
+    if (x0 > x1) { int t = x0; x0 = x1; x1 = t; }
+    if ((y < 0) || (y >= GVRAM_H) || (x1 < 0) || (x0 >= GVRAM_W)) {
+        return;
+    }
+    if (x0 < 0) x0 = 0;
+    if (x1 >= GVRAM_W) x1 = GVRAM_W - 1;
+    uint32_t v = GV_FILL(col);
+    uint32_t *p = &gvram[y][x0 / GV_PPW];
+    uint32_t *e = &gvram[y][x1 / GV_PPW];
+    uint32_t head = ~0u << ((x0 % GV_PPW) * 2);
+    uint32_t tail = ~0u >> ((GV_PPW - 1 - x1 % GV_PPW) * 2);
+    // span within one word
+    if (p == e) {
+        GV_MERGE(p, head & tail, v);
+        return;
+    }
+    GV_MERGE(p, head, v);
+    for (p++; p < e; p++) {
+        *p = v;
+    }
+    GV_MERGE(e, tail, v);
+}
+
+// to write w (<= 16) pixels from bits at (x, y): set bits in fg, others in bg
+// (GV_NONE keeps the background); at most two words are updated
+void gvram_put_bits( int x, int y, uint32_t bits, int w, int fg, int bg ) {
+    if ((y < 0) || (y >= GVRAM_H) || (x >= GVRAM_W) || (x + w <= 0)) {
+        return;
+    }
+    // clip left and right
+    if (x < 0) {
+        bits >>= -x;
+        w += x;
+        x = 0;
+    }
+    if (x + w > GVRAM_W) {
+        w = GVRAM_W - x;
+    }
+    uint32_t span = (w >= GV_PPW) ? ~0u : (1u << (w * 2)) - 1;
+    uint32_t mask = GV_MASK(bits) & span;
+    uint32_t value = mask & GV_FILL(fg);
+    if (bg != GV_NONE) {
+        value |= ~mask & span & GV_FILL(bg);
+        mask = span;
+    }
+    // shift into position and merge into one or two words
+    int s = (x % GV_PPW) * 2;
+    uint64_t m64 = (uint64_t)mask << s;
+    uint64_t v64 = (uint64_t)value << s;
+    uint32_t *p = &gvram[y][x / GV_PPW];
+    GV_MERGE(p, (uint32_t)m64, (uint32_t)v64);
+    if ((m64 >> 32) != 0) {
+        GV_MERGE(p + 1, (uint32_t)(m64 >> 32), (uint32_t)(v64 >> 32));
+    }
+}
+
+#endif
@@ -0,0 +1,124 @@
+/**
+ * Decoder of the colour mode (host build).
+ *
+ * Runs the PIO video engine in ntsc_color160 with bars of the 16 colours,
+ * takes a line of the samples sent to the PIO (host_video[]) and decodes it
+ * like a TV: the phase of the colour burst against a free-running
+ * subcarrier, then the luma, hue (relative to the burst, degrees from +U)
+ * and saturation of each bar.  Checks that the burst is in the same phase
+ * on every line and that each hue is within HUE_TOLERANCE of the palette.
+ *
+ *   color_check_host
+ */
+
+#include <stdio.h>
+#include <math.h>
+#include "pico/stdlib.h"
+#include "ntsc_video.h"
+
+#define BAR_W           10      // pixels per bar
+#define HUE_TOLERANCE   35      // degrees (dark colours have patterns of hues 45 degrees apart only)
+#define CHROMA_MIN      60      // mV of chroma below which a colour is gray
+
+int line_samples;               // samples per line
+uint8_t samples[NTSC_WORDS_MAX * 16];
+
+// to run the video until line is sent and take its samples
+void capture_line( int line ) {
+    static int sent = 0;        // lines sent since the start of video
+    while (1) {
+        uint32_t pos = host_video_pos;
+        host_run_lines(1);
+        if (sent++ % ntsc_lines != line) {
+            continue;
+        }
+        for (int i = 0; i < line_samples; i++) {
+            uint32_t w = host_video[(pos + i / 16) % HOST_VIDEO_WORDS];
+            samples[i] = (w >> ((i % 16) * 2)) & 3;
+        }
+        return;
+    }
+}
+
+// phase [degrees] and amplitude [mV] of the subcarrier in samples from..to-1
+// (whole cycles), against sin(2 pi n / 4) of the sample index n in the line
+double demodulate( int from, int to, double *amp ) {
+    double s = 0, c = 0;
+    for (int n = from; n < to; n++) {
+        double v = ntsc_level_mv(samples[n]);
+        s += v * sin(M_PI / 2 * n);
+        c += v * cos(M_PI / 2 * n);
+    }
+    *amp = 2 * sqrt(s * s + c * c) / (to - from);
+    return atan2(c, s) * 180 / M_PI;
+}
+
+// difference of angles in -180..180
+double angle_diff( double a, double b ) {
+    double d = fmod(a - b + 540, 360) - 180;
+    return d;
+}
+
+int main() {
+    set_sys_clock_pll(NTSC_COLOR_VCO, NTSC_COLOR_PD1, NTSC_COLOR_PD2);
+    ntsc_video_init(&ntsc_color160);
+    line_samples = ntsc_color160.samples;
+    for (int c = 0; c < NTSC_COLORS; c++) {
+        ntsc_color_fill_rect(c * BAR_W, 0, BAR_W, NTSC_PIX_H, c);
+    }
+    double rate = (double)clock_get_hz(clk_sys) * 256 / (pio0->clkdiv[0] >> 8);
+    printf("sample clock %.0f Hz (4 fsc %.0f Hz), %d samples per line\n",
+        rate, 4 * 315e6 / 88, line_samples);
+
+    int errors = 0;
+    double burst_first = 0;
+    for (int y = 0; y < 4; y++) {
+        int line = ntsc_v_base + y;
+        capture_line(line);
+        // end of sync, and the burst: samples above black before the active area
+        int n = 0;
+        while (n < line_samples && samples[n] == NTSC_SYNC) n++;
+        int from = n;
+        while (from < line_samples && samples[from] == NTSC_BLACK) from++;
+        int to = from;
+        while (to < line_samples && (samples[to] != NTSC_BLACK || samples[to + 1] != NTSC_BLACK
+            || samples[to + 2] != NTSC_BLACK)) to++;
+        to = from + (to - from + 3) / 4 * 4;        // whole cycles
+        double amp, burst = demodulate(from, to, &amp);
+        printf("line %3d: sync %d samples, burst %d..%d (%d cycles) phase %6.1f amplitude %3.0f mV\n",
+            line, n, from, to, (to - from) / 4, burst, amp);
+        if (y == 0) {
+            burst_first = burst;
+        } else if (fabs(angle_diff(burst, burst_first)) > 1) {
+            printf("  burst phase moved by %.1f degrees\n", angle_diff(burst, burst_first));
+            errors++;
+        }
+        if (y != 0) continue;
+        // bars: luma, hue relative to the burst (burst is at 180 degrees of U)
+        printf("colour  RGB          Y[mV]  hue  target  chroma[mV]\n");
+        for (int c = 0; c < NTSC_COLORS; c++) {
+            int x0 = ntsc_color160.h_start + (c * BAR_W + 2) * 4;
+            int x1 = x0 + (BAR_W - 4) * 4;
+            double y_mv = 0;
+            for (int i = x0; i < x1; i++) {
+                y_mv += ntsc_level_mv(samples[i]);
+            }
+            y_mv = y_mv / (x1 - x0) - NTSC_BLACK_MV;
+            double chroma, hue = angle_diff(demodulate(x0, x1, &chroma), burst - 180);
+            const uint8_t *rgb = ntsc_palette_rgb[c];
+            double py = 0.299 * rgb[0] + 0.587 * rgb[1] + 0.114 * rgb[2];
+            double u = 0.492 * (rgb[2] - py), v = 0.877 * (rgb[0] - py);
+            double target = atan2(v, u) * 180 / M_PI;
+            bool colored = (chroma >= CHROMA_MIN);
+            bool ok = true;
+            if (sqrt(u * u + v * v) * (NTSC_WHITE_MV - NTSC_BLACK_MV) / 255 >= CHROMA_MIN) {
+                ok = colored && fabs(angle_diff(hue, target)) <= HUE_TOLERANCE;
+            }
+            printf("%2d  %3d %3d %3d  %6.0f  %5.0f  %6.0f  %6.0f  %s\n", c, rgb[0], rgb[1], rgb[2],
+                y_mv, colored ? hue : 0, target, chroma, ok ? "" : "NG");
+            errors += !ok;
+        }
+    }
+    printf("%s\n", (errors == 0) ? "OK" : "NG");
+    return (errors == 0) ? 0 : 1;
+}
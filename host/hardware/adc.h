@@ -0,0 +1,2 @@
+// host stub of <hardware/adc.h>
+#include "host_hal.h"
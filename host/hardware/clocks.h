@@ -0,0 +1,2 @@
+// host stub of <hardware/clocks.h>
+#include "host_hal.h"
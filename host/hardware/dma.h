@@ -0,0 +1,2 @@
+// host stub of <hardware/dma.h>
+#include "host_hal.h"
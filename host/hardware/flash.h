@@ -0,0 +1,2 @@
+// host stub of <hardware/flash.h>
+#include "host_hal.h"
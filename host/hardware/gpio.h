@@ -0,0 +1,2 @@
+// host stub of <hardware/gpio.h>
+#include "host_hal.h"
@@ -0,0 +1,2 @@
+// host stub of <hardware/interp.h>
+#include "host_hal.h"
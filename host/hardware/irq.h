@@ -0,0 +1,2 @@
+// host stub of <hardware/irq.h>
+#include "host_hal.h"
@@ -0,0 +1,2 @@
+// host stub of <hardware/pio.h>
+#include "host_hal.h"
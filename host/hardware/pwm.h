@@ -0,0 +1,2 @@
+// host stub of <hardware/pwm.h>
+#include "host_hal.h"
@@ -0,0 +1,2 @@
+// host stub of <hardware/sync.h>
+#include "host_hal.h"
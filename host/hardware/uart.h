@@ -0,0 +1,2 @@
+// host stub of <hardware/uart.h>
+#include "host_hal.h"
@@ -0,0 +1,2 @@
+// host stub of <hardware/vreg.h>
+#include "host_hal.h"
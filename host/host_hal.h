@@ -0,0 +1,489 @@
+/**
+ * Stub HAL for the headless host build of the NTSC programs.
+ *
+ * Replaces the Pico SDK calls used by the programs (GPIO, ADC, PWM, IRQ,
+ * DMA, PIO, interpolators, clocks, vreg, flash, sleep, stdio drivers, UART) so that the game logic runs on Linux as
+ * fast as possible.
+ * The video interrupt is never raised by itself; host_run_lines() calls the
+ * registered handler (or completes the video DMA transfer of the PIO video
+ * engine, capturing its samples in host_video[]) when a program wants to
+ * exercise the scanline code.
+ * The levels the bit-banged programs write to GPIO15:GPIO14 are kept in
+ * host_level[] after host_level_n is set to 0.
+ *
+ * Environment:
+ *   NTSC_SEED  : value returned by adc_read() (random seed source)
+ *   NTSC_KEYS  : seed of the scripted key input (default 1)
+ *   NTSC_UART  : file received by the UART (a DMA channel paced by its RX
+ *                DREQ gets the bytes at the baud rate as lines run); the
+ *                program exits two frames after the end of the file
+ *   NTSC_UART_BAUD : baud rate of the file instead of that of uart_init()
+ */
+
+#ifndef __HOST_HAL__
+#define __HOST_HAL__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef unsigned int uint;
+typedef void (*irq_handler_t)(void);
+
+#define GPIO_IN         false
+#define GPIO_OUT        true
+#define GPIO_FUNC_UART  2
+#define GPIO_FUNC_PWM   4
+#define PWM_IRQ_WRAP    4
+#define HOST_IRQ_NUM    32
+#define HOST_KEY_HOLD   64      // key scans to hold a scripted key state
+#define HOST_DMA_NUM    12      // number of DMA channels
+#define HOST_VIDEO_WORDS    (262 * 128) // words of video output kept (a frame)
+#define DMA_IRQ_0       11
+#define DREQ_FORCE      0x3F    // unpaced DMA transfer
+#define HOST_DREQ_PIO   16      // DREQs of the PIOs (the video) are 0..15
+#define DREQ_UART0_RX   21
+#define DREQ_UART1_RX   23
+#define DREQ_DMA_TIMER0 0x3B    // DREQs of the DMA timers are 0x3B..0x3E
+#define HOST_LINE_NS    63556   // line period of the UART feed
+#define HOST_UART_DRAIN 525     // lines run after the end of NTSC_UART before exit
+#define HOST_LEVEL_MAX  1024    // levels of GPIO15:GPIO14 kept by host_level[]
+
+#define __scratch_x(group)
+#define __scratch_y(group)
+#define __not_in_flash(group)
+#define __not_in_flash_func(func_name)  func_name
+
+#define PICO_FLASH_SIZE_BYTES   (2 * 1024 * 1024)
+#define FLASH_PAGE_SIZE         256
+#define FLASH_SECTOR_SIZE       4096
+
+uint32_t host_gpio_out = 0;             // output level of all GPIOs
+uint32_t host_gpio_in = 0;              // input level of all GPIOs ('H' = released)
+uint16_t host_adc_value = 0;            // value returned by adc_read()
+uint32_t host_key_state = 1;            // state of scripted key input
+uint32_t host_key_count = 0;            // key scans since last key change
+irq_handler_t host_irq_handler[HOST_IRQ_NUM];
+uint8_t host_level[HOST_LEVEL_MAX];     // levels written to GPIO15:GPIO14 since host_level_n = 0
+int host_level_n = -1;                  // number of levels in host_level[], -1 = not kept
+uint8_t host_flash[PICO_FLASH_SIZE_BYTES];  // emulated flash memory
+
+#define XIP_BASE    ((uintptr_t)host_flash)
+
+// scripted key input: change pushed keys every HOST_KEY_HOLD scans
+uint32_t host_keys( void ) {
+    if (host_key_count++ % HOST_KEY_HOLD == 0) {
+        host_key_state = host_key_state * 1103515245 + 12345;
+        // each key is pushed with probability 1/4
+        host_gpio_in = ~((host_key_state >> 8) & (host_key_state >> 16));
+    }
+    return host_gpio_in;
+}
+
+// GPIO
+void gpio_init( uint gpio ) { }
+void gpio_init_mask( uint32_t mask ) { }
+void gpio_set_dir( uint gpio, bool out ) { }
+void gpio_set_dir_out_masked( uint32_t mask ) { }
+void gpio_pull_up( uint gpio ) { }
+void gpio_set_function( uint gpio, uint fn ) { }
+
+void gpio_put_masked( uint32_t mask, uint32_t value ) {
+    host_gpio_out = (host_gpio_out & ~mask) | (value & mask);
+    if (host_level_n >= 0 && host_level_n < HOST_LEVEL_MAX) {
+        host_level[host_level_n++] = (host_gpio_out >> 14) & 3;
+    }
+}
+
+bool gpio_get( uint gpio ) {
+    return (host_keys() >> gpio) & 1;
+}
+
+// time
+void sleep_us( uint64_t us ) { }
+void busy_wait_at_least_cycles( uint32_t minimum_cycles ) { }
+void sleep_ms( uint32_t ms ) { }
+
+// stdio
+bool stdio_init_all( void ) {
+    char *s;
+    if ((s = getenv("NTSC_SEED")) != NULL) host_adc_value = (uint16_t)atoi(s);
+    if ((s = getenv("NTSC_KEYS")) != NULL) host_key_state = (uint32_t)atoi(s);
+    memset(host_flash, 0xFF, sizeof(host_flash));
+    return true;
+}
+
+// stdio drivers: stdout is copied to the enabled driver (the Pico sends it
+// to every enabled driver), and still goes to the terminal
+typedef struct stdio_driver {
+    void (*out_chars)( const char *buf, int len );
+    void (*out_flush)( void );
+    int (*in_chars)( char *buf, int len );
+} stdio_driver_t;
+stdio_driver_t *host_stdio_driver = NULL;
+FILE *host_stdout = NULL;               // stdout of the terminal
+
+ssize_t host_stdio_write( void *cookie, const char *buf, size_t len ) {
+    fwrite(buf, 1, len, host_stdout);
+    if (host_stdio_driver != NULL) {
+        host_stdio_driver->out_chars(buf, (int)len);
+    }
+    return len;
+}
+
+void stdio_set_driver_enabled( stdio_driver_t *driver, bool enabled ) {
+    host_stdio_driver = enabled ? driver : NULL;
+    if (enabled && host_stdout == NULL) {
+        cookie_io_functions_t io = { NULL, host_stdio_write, NULL, NULL };
+        host_stdout = stdout;
+        stdout = fopencookie(NULL, "w", io);
+        setvbuf(stdout, NULL, _IOLBF, BUFSIZ);
+    }
+}
+
+// ADC
+void adc_init( void ) { }
+void adc_set_temp_sensor_enabled( bool enable ) { }
+void adc_select_input( uint input ) { }
+uint16_t adc_read( void ) { return host_adc_value; }
+
+// PWM
+typedef struct { uint32_t csr, div, top; } pwm_config;
+pwm_config pwm_get_default_config( void ) { pwm_config c = {0, 16, 0xFFFF}; return c; }
+uint pwm_gpio_to_slice_num( uint gpio ) { return (gpio >> 1) & 7; }
+void pwm_clear_irq( uint slice_num ) { }
+void pwm_set_irq_enabled( uint slice_num, bool enabled ) { }
+void pwm_set_wrap( uint slice_num, uint16_t wrap ) { }
+void pwm_set_enabled( uint slice_num, bool enabled ) { }
+
+// IRQ
+void irq_set_priority( uint num, uint8_t priority ) { }
+void irq_set_enabled( uint num, bool enabled ) { }
+void irq_set_exclusive_handler( uint num, irq_handler_t handler ) {
+    host_irq_handler[num] = handler;
+}
+
+// DMA: an unpaced transfer or one paced by a DMA timer completes when
+// triggered and triggers the chained channel; a transfer paced by a PIO
+// DREQ (video output) completes in host_run_lines(), which appends the
+// words to host_video[], triggers the chained channel and raises DMA_IRQ_0
+enum dma_channel_transfer_size { DMA_SIZE_8 = 0, DMA_SIZE_16 = 1, DMA_SIZE_32 = 2 };
+typedef struct { uint32_t size, dreq, chain_to, ring_bits; bool read_inc, write_inc, ring_write; } dma_channel_config;
+typedef struct { volatile uint32_t read_addr, write_addr, transfer_count, ctrl_trig; } dma_channel_hw_t;
+typedef struct {
+    dma_channel_config c;
+    volatile void *write;
+    const volatile void *read;
+    uint count;
+    bool busy;
+} host_dma_channel;
+host_dma_channel host_dma[HOST_DMA_NUM];
+uint32_t host_dma_claimed = 0;          // bit mask of claimed channels
+uint32_t host_dma_irq0_enabled = 0;     // channels raising DMA_IRQ_0
+uint32_t host_dma_ints0 = 0;            // DMA_IRQ_0 status
+uint32_t host_video[HOST_VIDEO_WORDS];  // words sent to the video PIO (ring)
+uint32_t host_video_pos = 0;            // number of words sent
+dma_channel_hw_t host_dma_hw[HOST_DMA_NUM]; // registers read by dma_channel_hw_addr()
+
+int dma_claim_unused_channel( bool required ) {
+    for (int ch = 0; ch < HOST_DMA_NUM; ch++) {
+        if ((host_dma_claimed & (1u << ch)) == 0) {
+            host_dma_claimed |= 1u << ch;
+            return ch;
+        }
+    }
+    if (required) {
+        fprintf(stderr, "no DMA channel\n");
+        exit(1);
+    }
+    return -1;
+}
+dma_channel_config dma_channel_get_default_config( uint channel ) {
+    dma_channel_config c = {DMA_SIZE_32, DREQ_FORCE, channel, 0, true, false, false};
+    return c;
+}
+void channel_config_set_transfer_data_size( dma_channel_config *c, enum dma_channel_transfer_size size ) {
+    c->size = size;
+}
+void channel_config_set_read_increment( dma_channel_config *c, bool incr ) { c->read_inc = incr; }
+void channel_config_set_write_increment( dma_channel_config *c, bool incr ) { c->write_inc = incr; }
+void channel_config_set_dreq( dma_channel_config *c, uint dreq ) { c->dreq = dreq; }
+void channel_config_set_chain_to( dma_channel_config *c, uint chain_to ) { c->chain_to = chain_to; }
+void channel_config_set_ring( dma_channel_config *c, bool write, uint size_bits ) {
+    c->ring_write = write;
+    c->ring_bits = size_bits;
+}
+void channel_config_set_high_priority( dma_channel_config *c, bool high_priority ) { }
+uint32_t host_dma_timers = 0;           // bit mask of claimed DMA timers
+int dma_claim_unused_timer( bool required ) {
+    for (int t = 0; t < 4; t++) {
+        if ((host_dma_timers & (1u << t)) == 0) {
+            host_dma_timers |= 1u << t;
+            return t;
+        }
+    }
+    if (required) {
+        fprintf(stderr, "no DMA timer\n");
+        exit(1);
+    }
+    return -1;
+}
+void dma_timer_set_fraction( uint timer, uint16_t numerator, uint16_t denominator ) { }
+uint dma_get_timer_dreq( uint timer_num ) { return DREQ_DMA_TIMER0 + timer_num; }
+
+// do the transfer of a channel (to host_video[] if paced by the video PIO)
+void host_dma_transfer( uint channel ) {
+    host_dma_channel *d = &host_dma[channel];
+    int n = 1 << d->c.size;
+    uint8_t *w = (uint8_t *)d->write;
+    const uint8_t *r = (const uint8_t *)d->read;
+    for (uint i = 0; i < d->count; i++) {
+        if (d->c.dreq < HOST_DREQ_PIO) {
+            uint32_t v = 0;
+            memcpy(&v, r, n);
+            host_video[host_video_pos++ % HOST_VIDEO_WORDS] = v;
+        } else {
+            memcpy(w, r, n);
+            if (d->c.write_inc) w += n;
+        }
+        if (d->c.read_inc) r += n;
+    }
+    d->read = r;
+    d->busy = false;
+}
+
+void dma_channel_start( uint channel ) {
+    host_dma[channel].busy = true;
+    if (host_dma[channel].c.dreq >= DREQ_DMA_TIMER0) {
+        host_dma_transfer(channel);
+        if (host_dma[channel].c.chain_to != channel) {
+            dma_channel_start(host_dma[channel].c.chain_to);
+        }
+    }
+}
+void dma_channel_configure( uint channel, const dma_channel_config *c, volatile void *write_addr,
+                            const volatile void *read_addr, uint transfer_count, bool trigger ) {
+    host_dma[channel].c = *c;
+    host_dma[channel].write = write_addr;
+    host_dma[channel].read = read_addr;
+    host_dma[channel].count = transfer_count;
+    if (trigger) {
+        dma_channel_start(channel);
+    }
+}
+void dma_channel_set_read_addr( uint channel, const volatile void *read_addr, bool trigger ) {
+    host_dma[channel].read = read_addr;
+    if (trigger) {
+        dma_channel_start(channel);
+    }
+}
+void dma_channel_set_irq0_enabled( uint channel, bool enabled ) {
+    host_dma_irq0_enabled = enabled ? host_dma_irq0_enabled | (1u << channel)
+                                    : host_dma_irq0_enabled & ~(1u << channel);
+}
+bool dma_channel_get_irq0_status( uint channel ) { return (host_dma_ints0 >> channel) & 1; }
+void dma_channel_acknowledge_irq0( uint channel ) { host_dma_ints0 &= ~(1u << channel); }
+void dma_channel_wait_for_finish_blocking( uint channel ) { }
+bool dma_channel_is_busy( uint channel ) { return host_dma[channel].busy; }
+dma_channel_hw_t *dma_channel_hw_addr( uint channel ) {
+    host_dma_hw[channel].transfer_count = host_dma[channel].count;
+    host_dma_hw[channel].write_addr = (uint32_t)(uintptr_t)host_dma[channel].write;
+    return &host_dma_hw[channel];
+}
+void dma_channel_set_trans_count( uint channel, uint32_t trans_count, bool trigger ) {
+    host_dma[channel].count = trans_count;
+    if (trigger) {
+        dma_channel_start(channel);
+    }
+}
+
+// UART: the receiver gets NTSC_UART at the baud rate, a line at a time
+typedef struct { int id; volatile uint32_t dr; } uart_hw_t;
+typedef uart_hw_t uart_inst_t;
+uart_hw_t host_uart0 = {0, 0}, host_uart1 = {1, 0};
+#define uart0   (&host_uart0)
+#define uart1   (&host_uart1)
+FILE *host_uart_file = NULL;            // file received
+uint32_t host_uart_baud = 0;            // baud rate of the file
+uint64_t host_uart_credit = 0;          // bits received and not yet taken [1/HOST_LINE_NS]
+int host_uart_drain = -1;               // lines to exit after the end of the file
+
+uint uart_init( uart_inst_t *uart, uint baudrate ) {
+    char *s;
+    host_uart_baud = baudrate;
+    if ((s = getenv("NTSC_UART_BAUD")) != NULL) host_uart_baud = (uint32_t)atol(s);
+    if ((s = getenv("NTSC_UART")) != NULL && host_uart_file == NULL) {
+        host_uart_file = fopen(s, "rb");
+        if (host_uart_file == NULL) {
+            perror(s);
+            exit(1);
+        }
+    }
+    return baudrate;
+}
+void uart_set_fifo_enabled( uart_inst_t *uart, bool enabled ) { }
+uart_hw_t *uart_get_hw( uart_inst_t *uart ) { return uart; }
+uint uart_get_dreq( uart_inst_t *uart, bool is_tx ) { return uart->id ? DREQ_UART1_RX - is_tx : DREQ_UART0_RX - is_tx; }
+
+// to give a DMA channel paced by a UART receiver the bytes of a line
+void host_uart_feed( uint channel ) {
+    host_dma_channel *d = &host_dma[channel];
+    host_uart_credit += (uint64_t)host_uart_baud * HOST_LINE_NS;
+    uint64_t byte_ns = 10ull * 1000000000;  // 10 bits a byte
+    while (host_uart_credit >= byte_ns && d->count > 0 && host_uart_drain < 0) {
+        int c = fgetc(host_uart_file);
+        if (c == EOF) {
+            host_uart_drain = HOST_UART_DRAIN;
+            break;
+        }
+        host_uart_credit -= byte_ns;
+        uint8_t *w = (uint8_t *)d->write;
+        *w++ = (uint8_t)c;
+        if (d->c.ring_write && d->c.ring_bits != 0) {
+            uintptr_t size = (uintptr_t)1 << d->c.ring_bits;
+            w = (uint8_t *)(((uintptr_t)w & (size - 1)) | ((uintptr_t)d->write & ~(size - 1)));
+        }
+        d->write = w;
+        d->count--;
+    }
+    if (d->count == 0) {
+        d->busy = false;
+    }
+}
+
+// run n horizontal lines: complete the running video DMA transfer, or call
+// the PWM interrupt handler of the bit-banged programs
+void host_run_lines( int n ) {
+    for (int i = 0; i < n; i++) {
+        int ch;
+        // receivers of the UART
+        for (ch = 0; ch < HOST_DMA_NUM; ch++) {
+            if (host_dma[ch].busy && (host_dma[ch].c.dreq == DREQ_UART0_RX || host_dma[ch].c.dreq == DREQ_UART1_RX)
+                && host_uart_file != NULL) {
+                host_uart_feed(ch);
+            }
+        }
+        if (host_uart_drain >= 0 && host_uart_drain-- == 0) {
+            exit(0);
+        }
+        // the video
+        for (ch = 0; ch < HOST_DMA_NUM; ch++) {
+            if (host_dma[ch].busy && host_dma[ch].c.dreq < HOST_DREQ_PIO) break;
+        }
+        if (ch < HOST_DMA_NUM) {
+            host_dma_transfer(ch);
+            if (host_dma[ch].c.chain_to != (uint32_t)ch) {
+                dma_channel_start(host_dma[ch].c.chain_to);
+            }
+            if ((host_dma_irq0_enabled >> ch) & 1) {
+                host_dma_ints0 |= 1u << ch;
+                if (host_irq_handler[DMA_IRQ_0] != NULL) host_irq_handler[DMA_IRQ_0]();
+            }
+        } else if (host_irq_handler[PWM_IRQ_WRAP] != NULL) {
+            host_irq_handler[PWM_IRQ_WRAP]();
+        } else {
+            return;
+        }
+    }
+}
+
+// PIO (no state machine runs; the video DMA feeds host_video[])
+typedef struct { int id; uint32_t txf[4]; uint32_t clkdiv[4]; } host_pio;
+typedef host_pio *PIO;
+host_pio host_pio0 = {0}, host_pio1 = {1};
+#define pio0    (&host_pio0)
+#define pio1    (&host_pio1)
+enum pio_fifo_join { PIO_FIFO_JOIN_NONE = 0, PIO_FIFO_JOIN_TX = 1, PIO_FIFO_JOIN_RX = 2 };
+typedef struct { uint32_t clkdiv, execctrl, shiftctrl, pinctrl; } pio_sm_config;
+typedef struct { const uint16_t *instructions; uint8_t length; int8_t origin; } pio_program_t;
+uint32_t host_pio_claimed = 0;          // bit mask of claimed state machines (pio0: 0..3, pio1: 4..7)
+
+uint pio_add_program( PIO pio, const pio_program_t *program ) { return 0; }
+int pio_claim_unused_sm( PIO pio, bool required ) {
+    for (int sm = 0; sm < 4; sm++) {
+        uint32_t bit = 1u << (pio->id * 4 + sm);
+        if ((host_pio_claimed & bit) == 0) {
+            host_pio_claimed |= bit;
+            return sm;
+        }
+    }
+    return -1;
+}
+pio_sm_config pio_get_default_sm_config( void ) { pio_sm_config c = {0, 0, 0, 0}; return c; }
+void sm_config_set_out_pins( pio_sm_config *c, uint out_base, uint out_count ) { }
+void sm_config_set_out_shift( pio_sm_config *c, bool shift_right, bool autopull, uint pull_threshold ) { }
+void sm_config_set_fifo_join( pio_sm_config *c, enum pio_fifo_join join ) { }
+void sm_config_set_clkdiv_int_frac( pio_sm_config *c, uint16_t div_int, uint8_t div_frac ) {
+    c->clkdiv = ((uint32_t)div_int << 16) | ((uint32_t)div_frac << 8);
+}
+void sm_config_set_wrap( pio_sm_config *c, uint wrap_target, uint wrap ) { }
+void pio_gpio_init( PIO pio, uint pin ) { }
+void pio_sm_set_consecutive_pindirs( PIO pio, uint sm, uint pin, uint count, bool is_out ) { }
+void pio_sm_init( PIO pio, uint sm, uint initial_pc, const pio_sm_config *config ) {
+    pio->clkdiv[sm] = config->clkdiv;
+}
+void pio_sm_set_enabled( PIO pio, uint sm, bool enabled ) { }
+void pio_sm_set_clkdiv_int_frac( PIO pio, uint sm, uint16_t div_int, uint8_t div_frac ) { }
+uint pio_get_dreq( PIO pio, uint sm, bool is_tx ) { return pio->id * 8 + sm + (is_tx ? 0 : 4); }
+
+// clocks
+enum clock_index { clk_gpout0 = 0, clk_ref = 4, clk_sys = 5, clk_peri = 6, clk_usb = 7, clk_adc = 8, clk_rtc = 9 };
+uint32_t host_sys_hz = 125000000;       // system clock
+uint32_t clock_get_hz( enum clock_index clk_index ) { return host_sys_hz; }
+bool set_sys_clock_pll( uint32_t vco_freq, uint post_div1, uint post_div2 ) {
+    host_sys_hz = vco_freq / (post_div1 * post_div2);
+    return true;
+}
+
+// voltage regulator
+enum vreg_voltage { VREG_VOLTAGE_1_10 = 11, VREG_VOLTAGE_1_15 = 12, VREG_VOLTAGE_1_20 = 13,
+                    VREG_VOLTAGE_DEFAULT = VREG_VOLTAGE_1_10 };
+void vreg_set_voltage( enum vreg_voltage voltage ) { }
+
+// interpolators: lanes 0 and 1 with shift, mask and cross input (the base
+// and the results are host pointers, so they are uintptr_t here)
+typedef struct { uint32_t ctrl; } interp_config;
+typedef struct { uint32_t accum[2]; uintptr_t base[3]; uint32_t ctrl[2]; } interp_hw_t;
+interp_hw_t host_interp0, host_interp1;
+#define interp0 (&host_interp0)
+#define interp1 (&host_interp1)
+
+interp_config interp_default_config( void ) {
+    interp_config c = { 31u << 10 };    // shift 0, mask 0..31
+    return c;
+}
+void interp_config_set_shift( interp_config *c, uint shift ) {
+    c->ctrl = (c->ctrl & ~0x1Fu) | (shift & 0x1F);
+}
+void interp_config_set_mask( interp_config *c, uint mask_lsb, uint mask_msb ) {
+    c->ctrl = (c->ctrl & ~(0x3FFu << 5)) | ((mask_lsb & 0x1F) << 5) | ((mask_msb & 0x1F) << 10);
+}
+void interp_config_set_cross_input( interp_config *c, bool cross_input ) {
+    c->ctrl = (c->ctrl & ~(1u << 16)) | ((uint32_t)cross_input << 16);
+}
+void interp_set_config( interp_hw_t *interp, uint lane, interp_config *config ) {
+    interp->ctrl[lane] = config->ctrl;
+}
+void interp_set_base( interp_hw_t *interp, uint lane, uintptr_t val ) { interp->base[lane] = val; }
+void interp_set_accumulator( interp_hw_t *interp, uint lane, uint32_t val ) { interp->accum[lane] = val; }
+uintptr_t interp_peek_lane_result( interp_hw_t *interp, uint lane ) {
+    uint32_t ctrl = interp->ctrl[lane];
+    uint32_t in = interp->accum[lane ^ ((ctrl >> 16) & 1)];
+    uint32_t lsb = (ctrl >> 5) & 0x1F, msb = (ctrl >> 10) & 0x1F;
+    uint32_t mask = (uint32_t)((2ull << msb) - (1ull << lsb));
+    return interp->base[lane] + ((in >> (ctrl & 0x1F)) & mask);
+}
+
+// flash (erased state is 0xFF)
+uint32_t save_and_disable_interrupts( void ) { return 0; }
+void restore_interrupts( uint32_t status ) { }
+void flash_range_erase( uint32_t offset, size_t count ) {
+    memset(host_flash + offset, 0xFF, count);
+}
+void flash_range_program( uint32_t offset, const uint8_t *data, size_t count ) {
+    memcpy(host_flash + offset, data, count);
+}
+
+#endif
@@ -0,0 +1,34 @@
+// host stub of ntsc.pio.h (generated by pioasm from ntsc.pio in the Pico build)
+#ifndef __NTSC_PIO_H__
+#define __NTSC_PIO_H__
+
+#include "host_hal.h"
+
+#define ntsc_out_wrap_target 0
+#define ntsc_out_wrap 0
+
+static const uint16_t ntsc_out_program_instructions[] = {
+    0x6002, //  0: out    pins, 2
+};
+
+static const pio_program_t ntsc_out_program = {
+    .instructions = ntsc_out_program_instructions,
+    .length = 1,
+    .origin = -1,
+};
+
+static inline pio_sm_config ntsc_out_program_get_default_config( uint offset ) {
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset + ntsc_out_wrap_target, offset + ntsc_out_wrap);
+    return c;
+}
+
+static inline void ntsc_out_program_init( PIO pio, uint sm, uint offset, uint pin,
+                                          uint16_t div_int, uint8_t div_frac ) {
+    pio_sm_config c = ntsc_out_program_get_default_config(offset);
+    sm_config_set_clkdiv_int_frac(&c, div_int, div_frac);
+    pio_sm_init(pio, sm, offset, &c);
+    pio_sm_set_enabled(pio, sm, true);
+}
+
+#endif
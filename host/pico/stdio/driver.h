@@ -0,0 +1,2 @@
+// host stub of <pico/stdio/driver.h>
+#include "host_hal.h"
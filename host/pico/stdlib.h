@@ -0,0 +1,2 @@
+// host stub of <pico/stdlib.h>
+#include "host_hal.h"
@@ -0,0 +1,61 @@
+/**
+ * Checker of the text scanlines of a bit-banged program (host build).
+ *
+ * Built once per program (TEXT_CHECK_PROGRAM is its source): fills VRAM
+ * with all characters, runs horizontal_line() over the text area of a frame
+ * in each video profile (the strap forced to NTSC, PAL and PAL-M), and
+ * compares the levels written to GPIO15:GPIO14 (host_level[]) with the
+ * glyph row of ascii_table each line should show.  Reports the lines that
+ * differ, e.g. a glyph row out of step with the text row when V_BASE moves
+ * by video_v_shift.
+ *
+ *   test_ntsc_shot_text_check
+ */
+
+// the program without its main()
+#define main    program_main
+#include TEXT_CHECK_PROGRAM
+#undef main
+
+// to check the text lines of a frame in profile t; returns lines that differ
+int check_profile( const video_timing *t ) {
+    video_timing_select(t);
+    int bad = 0;
+    for (int line = V_BASE; line < V_BASE + VRAM_H * CHAR_H; line++) {
+        int y = (line - V_BASE) / CHAR_H;
+        int r = (line - V_BASE) % CHAR_H;
+        count = line;
+        host_level_n = 0;
+        horizontal_line();
+        // the pixels are the levels before the right blank
+        const uint8_t *pix = &host_level[host_level_n - 1 - VRAM_W * CHAR_W];
+        for (int x = 0; x < VRAM_W * CHAR_W; x++) {
+            unsigned char c = vram[y][x / CHAR_W];
+            int level = ((ascii_table[c][r] >> (x % CHAR_W)) & 1) ? 3 : 2;
+            if (pix[x] != level) {
+                if (bad++ == 0) {
+                    printf("%-6s line %d (row %d, glyph line %d): differs at pixel %d\n",
+                        t->name, line, y, r, x);
+                }
+                break;
+            }
+        }
+    }
+    host_level_n = -1;
+    printf("%-6s v_shift %2d: %d of %d text lines differ\n", t->name, video_v_shift, bad,
+        VRAM_H * CHAR_H);
+    return bad;
+}
+
+int main() {
+#ifdef __ATTR__
+    attr_init();
+#endif
+    for (int y = 0; y < VRAM_H; y++) {
+        for (int x = 0; x < VRAM_W; x++) {
+            vram[y][x] = 0x20 + (y * VRAM_W + x) % 0x5F;
+        }
+    }
+    int bad = check_profile(&video_ntsc) + check_profile(&video_pal) + check_profile(&video_palm);
+    return (bad == 0) ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+/**
+ * Benchmark of the text VRAM layouts on the scanline path (host build).
+ *
+ * Runs the text mode scanline kernel of the games over whole frames with
+ * the old column-major VRAM (vram[VRAM_W][VRAM_H]) and the row-major VRAM
+ * (vram[VRAM_H][VRAM_W]), and scrolls the play field down a row both ways.
+ * The stub gpio_put_masked() stands for the pixel output.
+ *
+ *   vram_bench_host [frames]
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "font8x8_basic.h"
+#include "font8x8_2bpp.h"     // generated by tools/fontgen
+#include "bench.h"
+
+#define GP14    14      // GPIO14 connected to RCA+ pin via 330 ohm
+#define GP15    15      // GPIO15 connected to RCA+ pin via 1k ohm
+#define M14     (1 << GP14) // bit mask for GPIO14
+#define M15     (1 << GP15) // bit mask for GPIO15
+#define LEVEL(v)    gpio_put_masked(M14 | M15, (v) << GP14)   // 2-bit level code (GPIO15:GPIO14)
+#define VRAM_W  30      // width size of VRAM
+#define VRAM_H  24      // height size of VRAM
+#define STARTW  1       // start x of scrolled area
+#define ENDW    28      // end x of scrolled area
+
+volatile unsigned char vram_col[VRAM_W][VRAM_H];    // column-major VRAM
+volatile unsigned char vram_row[VRAM_H][VRAM_W];    // row-major VRAM
+
+// scanline of the column-major VRAM
+void line_col( int line ) {
+    int y = line / CHAR_H;
+    const uint16_t *row = font8x8_2bpp[line % CHAR_H];
+    for (int x = 0; x < VRAM_W; x++) {
+        uint32_t pix = row[vram_col[x][y]];
+        for (int w = 0; w < CHAR_W; w++) {
+            LEVEL(pix & 3);
+            pix >>= 2;
+        }
+    }
+}
+
+// scanline of the row-major VRAM
+void line_row( int line ) {
+    const uint16_t *row = font8x8_2bpp[line % CHAR_H];
+    const volatile unsigned char *text = vram_row[line / CHAR_H];
+    for (int x = 0; x < VRAM_W; x++) {
+        uint32_t pix = row[text[x]];
+        for (int w = 0; w < CHAR_W; w++) {
+            LEVEL(pix & 3);
+            pix >>= 2;
+        }
+    }
+}
+
+// scroll down rows 1..VRAM_H-1 of the column-major VRAM
+void scroll_col( void ) {
+    for (int y = VRAM_H - 2; y >= 1; y--) {
+        for (int x = STARTW; x <= ENDW; x++) {
+            vram_col[x][y + 1] = vram_col[x][y];
+        }
+    }
+}
+
+// scroll down rows 1..VRAM_H-1 of the row-major VRAM
+void scroll_row( void ) {
+    for (int y = VRAM_H - 2; y >= 1; y--) {
+        memmove((void *)&vram_row[y + 1][STARTW], (void *)&vram_row[y][STARTW], ENDW - STARTW + 1);
+    }
+}
+
+int main( int argc, char *argv[] ) {
+    int frames = (argc > 1) ? atoi(argv[1]) : 20000;
+
+    for (int y = 0; y < VRAM_H; y++) {
+        for (int x = 0; x < VRAM_W; x++) {
+            vram_col[x][y] = vram_row[y][x] = (x * 7 + y * 3) % ASCII_CHAR_NUM;
+        }
+    }
+    bench_start = bench_now();
+    for (int f = 0; f < frames; f++) {
+        BENCH_BEGIN("frame column-major");
+        for (int line = 0; line < VRAM_H * CHAR_H; line++) {
+            line_col(line);
+        }
+        BENCH_END("frame column-major");
+        BENCH_BEGIN("frame row-major");
+        for (int line = 0; line < VRAM_H * CHAR_H; line++) {
+            line_row(line);
+        }
+        BENCH_END("frame row-major");
+        BENCH_BEGIN("scroll column-major");
+        scroll_col();
+        BENCH_END("scroll column-major");
+        BENCH_BEGIN("scroll row-major");
+        scroll_row();
+        BENCH_END("scroll row-major");
+        bench_ticks++;
+    }
+    // both layouts must hold the same text after the scrolls
+    for (int y = 0; y < VRAM_H; y++) {
+        for (int x = 0; x < VRAM_W; x++) {
+            if (vram_col[x][y] != vram_row[y][x]) {
+                printf("layouts differ at (%d, %d)\n", x, y);
+                return 1;
+            }
+        }
+    }
+    bench_report();
+    return 0;
+}
@@ -0,0 +1,164 @@
+/**
+ * HUD numeric fields without printf or division.
+ *
+ * A hud_field is a right-aligned number of fixed width (like "%6d") kept as
+ * BCD digits.  hud_set() adds small increments digit by digit with carry
+ * (or converts by subtracting powers of ten) and writes only the characters
+ * which differ from what is on the screen through the put function.
+ *
+ *   hud_field score;
+ *   hud_init(&score, 5, LSCORE, 6, vram_write);     // draws "     0"
+ *   hud_set(&score, 120);                           // writes "120" only
+ *
+ * put(x, y, c) receives the character column x (x advances by one per
+ * character) and y as given, so graphic programs can pass pixel lines.
+ *
+ * A value wider than its field saturates at 99..9 (-9..9 when negative,
+ * the sign taking a column) instead of losing its high digits, so a score
+ * of 1000000 in a 6-digit field shows 999999.
+ */
+
+#ifndef __HUD__
+#define __HUD__
+
+#define HUD_MAX_DIGITS  10      // max width of a field
+
+// to make a string literal of a numeric macro: HUD_STR(METEOR_SCORE) -> "10"
+#define HUD_STR_(x)     #x
+#define HUD_STR(x)      HUD_STR_(x)
+
+typedef void (*hud_put_func)( int x, int y, unsigned char c );
+
+typedef struct {
+    int x;                  // column of the leftmost character
+    int y;                  // line given to put()
+    int width;              // width of the field (characters)
+    int value;              // value shown
+    unsigned char digit[HUD_MAX_DIGITS];    // BCD digits, [0] = least significant
+    unsigned char shown[HUD_MAX_DIGITS];    // characters on the screen, [0] = rightmost
+    hud_put_func put;       // function to write a character
+} hud_field;
+
+const unsigned int hud_pow10[HUD_MAX_DIGITS] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+// to convert value into n BCD digits by subtracting powers of ten
+// (digits above n are dropped like an odometer)
+void hud_to_bcd( unsigned int value, unsigned char *digit, int n ) {
+    for (int i = HUD_MAX_DIGITS - 1; i >= 0; i--) {
+        unsigned char d = 0;
+        while (value >= hud_pow10[i]) {
+            value -= hud_pow10[i];
+            d++;
+        }
+        if (i < n) {
+            digit[i] = d;
+        }
+    }
+}
+
+// to clamp value to what width characters show (99..9 or -9..9)
+int hud_clamp( int value, int width ) {
+    int max = (width < HUD_MAX_DIGITS) ? (int)hud_pow10[width] - 1 : 0x7FFFFFFF;
+    int min = -((int)hud_pow10[width - 1] - 1);
+    return (value > max) ? max : (value < min) ? min : value;
+}
+
+// to write characters of the field which differ from the screen
+void hud_draw( hud_field *f, bool neg ) {
+    // most significant non-zero digit
+    int m = f->width - 1;
+    while (m > 0 && f->digit[m] == 0) {
+        m--;
+    }
+    for (int i = 0; i < f->width; i++) {
+        unsigned char c;
+        if (i <= m) {
+            c = '0' + f->digit[i];
+        } else if (neg && i == m + 1) {
+            c = '-';
+        } else {
+            c = ' ';
+        }
+        if (c != f->shown[i]) {
+            f->shown[i] = c;
+            f->put(f->x + f->width - 1 - i, f->y, c);
+        }
+    }
+}
+
+// to initialize a field showing 0
+void hud_init( hud_field *f, int x, int y, int width, hud_put_func put ) {
+    f->x = x;
+    f->y = y;
+    f->width = (width > HUD_MAX_DIGITS) ? HUD_MAX_DIGITS : width;
+    f->value = 0;
+    f->put = put;
+    for (int i = 0; i < HUD_MAX_DIGITS; i++) {
+        f->digit[i] = 0;
+        f->shown[i] = 0;
+    }
+    hud_draw(f, false);
+}
+
+// to set the value of a field; nothing is written if it is not changed
+void hud_set( hud_field *f, int value ) {
+    value = hud_clamp(value, f->width);
+    if (value == f->value) {
+        return;
+    }
+    // increment: add BCD digits of the difference with carry
+    if (value > f->value && f->value >= 0) {
+        unsigned char d[HUD_MAX_DIGITS];
+        unsigned char carry = 0;
+        hud_to_bcd(value - f->value, d, f->width);
+        for (int i = 0; i < f->width; i++) {
+            unsigned char s = f->digit[i] + d[i] + carry;
+            carry = (s >= 10);
+            f->digit[i] = carry ? s - 10 : s;
+        }
+    // otherwise convert the whole value
+    } else {
+        hud_to_bcd((value < 0) ? -value : value, f->digit, f->width);
+    }
+    f->value = value;
+    hud_draw(f, value < 0);
+}
+
+// to write a number once (no field state): width characters, right-aligned,
+// with point digits after a decimal point (0 = integer)
+void hud_number( int x, int y, int width, int point, int value, hud_put_func put ) {
+    unsigned char d[HUD_MAX_DIGITS];
+    bool neg = (value < 0);
+    hud_to_bcd(neg ? -value : value, d, HUD_MAX_DIGITS);
+    // most significant digit to show (at least one digit before the point)
+    int m = HUD_MAX_DIGITS - 1;
+    while (m > point && d[m] == 0) {
+        m--;
+    }
+    // saturate at 9..9 if the digits don't fit
+    int room = width - (point > 0) - neg;
+    if (m >= room) {
+        m = room - 1;
+        for (int i = 0; i <= m; i++) {
+            d[i] = 9;
+        }
+    }
+    int col = x + width - 1;
+    for (int i = 0; i <= m && col >= x; i++) {
+        if (point > 0 && i == point) {
+            put(col--, y, '.');
+            if (col < x) break;
+        }
+        put(col--, y, '0' + d[i]);
+    }
+    if (neg && col >= x) {
+        put(col--, y, '-');
+    }
+    while (col >= x) {
+        put(col--, y, ' ');
+    }
+}
+
+#endif
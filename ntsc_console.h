@@ -0,0 +1,148 @@
+/**
+ * Scrolling text console on the PIO video engine (ntsc_video.h).
+ *
+ * The rows from the first row of the console to the bottom are the ring of
+ * the text VRAM (ntsc_text_ring()), so a new line at the bottom is a move
+ * of the start row and the clear of a row, whatever the number of rows.
+ * The console is a stdio driver: printf() and puts() of the program put
+ * their characters into a FIFO, and the DMA interrupt writes up to
+ * CON_BATCH of them into the VRAM when the text area of a frame has been
+ * sent (ntsc_vblank_func), so the picture never shows half a scroll and
+ * printing costs a copy into the FIFO.  The interrupt has to rewind the
+ * other line channel too, so the batch also stops when CON_BUDGET_NS have
+ * passed (timed by the cycle counter of raster.h); the rest waits for the
+ * next frame.  A writer waits for the video only when the FIFO is full.
+ *
+ *   ntsc_video_init(&ntsc_text40);
+ *   con_init(3);                    // rows 3.. are the console
+ *   printf("T %d.%d\n", t / 10, t % 10);
+ *
+ * '\n' starts a new line, '\r' returns to the left, '\b' goes back a
+ * column, '\t' to the next multiple of 8 and '\f' clears the console;
+ * a line longer than the columns of the mode wraps.
+ */
+
+#ifndef __NTSC_CONSOLE__
+#define __NTSC_CONSOLE__
+
+#include "pico/stdlib.h"
+#include "pico/stdio/driver.h"
+#include "ntsc_video.h"
+
+#define CON_FIFO    1024    // characters waiting for the vblank (power of 2)
+#define CON_BATCH   256     // characters written per vblank
+#define CON_BUDGET_NS   20000   // time of the writes per vblank (a third of a line)
+#define CON_TAB     8       // tab stops
+
+char con_fifo[CON_FIFO];                // characters waiting
+volatile uint32_t con_head = 0;         // written by the program
+volatile uint32_t con_tail = 0;         // read by the DMA interrupt
+int con_first;                          // first row of the console
+int con_x, con_y;                       // cursor (row of the screen)
+uint32_t con_budget;                    // CON_BUDGET_NS in system clocks
+
+// to clear the console and put the cursor at its top left
+void __not_in_flash_func(con_clear)( void ) {
+    for (int y = con_first; y < ntsc_mode_now->rows; y++) {
+        uint32_t *p = (uint32_t *)ntsc_text[NTSC_TEXT_Y(y)];
+        for (int i = 0; i < NTSC_COLS_MAX / 4; i++) {
+            p[i] = 0x20202020;
+        }
+    }
+    con_x = 0;
+    con_y = con_first;
+}
+
+// to move the cursor to a new line (scrolling at the bottom)
+void __not_in_flash_func(con_newline)( void ) {
+    con_x = 0;
+    if (con_y + 1 < ntsc_mode_now->rows) {
+        con_y++;
+    } else {
+        ntsc_text_roll();
+    }
+}
+
+// to write a character at the cursor
+void __not_in_flash_func(con_putc)( char c ) {
+    switch (c) {
+    case '\n':
+        con_newline();
+        break;
+    case '\r':
+        con_x = 0;
+        break;
+    case '\b':
+        if (con_x > 0) con_x--;
+        break;
+    case '\t':
+        con_x = (con_x / CON_TAB + 1) * CON_TAB;
+        if (con_x >= ntsc_mode_now->cols) con_newline();
+        break;
+    case '\f':
+        con_clear();
+        break;
+    default:
+        if (con_x >= ntsc_mode_now->cols) con_newline();
+        ntsc_text[NTSC_TEXT_Y(con_y)][con_x++] = c;
+        break;
+    }
+}
+
+// vblank: write a batch of the waiting characters within the budget (from
+// the DMA interrupt)
+void __not_in_flash_func(con_vblank)( void ) {
+    uint32_t tail = con_tail, head = con_head;
+    uint32_t start = raster_now();
+    for (int n = 0; tail != head && n < CON_BATCH; n++) {
+        con_putc(con_fifo[tail++ % CON_FIFO]);
+        if (((raster_now() - start) & RASTER_CYCLE_MASK) >= con_budget) {
+            break;
+        }
+    }
+    con_tail = tail;
+}
+
+// to put characters into the FIFO, waiting for the vblank when it is full
+void con_write( const char *buf, int len ) {
+    for (int i = 0; i < len; i++) {
+        while (con_head - con_tail >= CON_FIFO) {
+#ifdef NTSC_HOST
+            host_run_lines(1);
+#else
+            __wfi();
+#endif
+        }
+        con_fifo[con_head % CON_FIFO] = buf[i];
+        con_head++;
+    }
+}
+
+// to wait until the characters written have been shown
+void con_flush( void ) {
+    while (con_tail != con_head) {
+#ifdef NTSC_HOST
+        host_run_lines(1);
+#else
+        __wfi();
+#endif
+    }
+}
+
+stdio_driver_t con_driver = {
+    .out_chars = con_write,
+    .out_flush = con_flush,
+};
+
+// to make rows first..bottom of the screen the console and send stdio to it
+void con_init( int first ) {
+    con_first = first;
+    ntsc_text_ring(first);
+    con_clear();
+    con_head = con_tail = 0;
+    con_budget = (uint64_t)clock_get_hz(clk_sys) * CON_BUDGET_NS / 1000000000;
+    ntsc_vblank_func = con_vblank;
+    stdio_set_driver_enabled(&con_driver, true);
+}
+
+#endif
@@ -0,0 +1,636 @@
+/**
+ * PIO video engine for the NTSC programs: text modes of 40 and 64 columns,
+ * low-resolution graphic modes and a colour graphic mode.
+ *
+ * The bit-banged scanline of the other programs can't put out pixels much
+ * faster than 32 columns.  Here a PIO state machine (ntsc.pio) shifts 2-bit
+ * level codes to GPIO14/15 at the sample rate of the mode, fed by two DMA
+ * channels chained to each other, each sending a whole line (sync, porches
+ * and pixels) from its own line buffer.  When a channel finishes, its
+ * buffer is built again for the line after next in the DMA interrupt, so
+ * the CPU only composes lines from the text VRAM and the font.
+ *
+ * Video modes (selected by ntsc_video_init()):
+ *   ntsc_text40 : 40 x 24 characters, 8x8 font, 400 samples/line (6.3 MHz)
+ *   ntsc_text64 : 64 x 24 characters, 6x8 font, 512 samples/line (8 MHz)
+ *   ntsc_color160 : 160 x 192 pixels of 16 colours, 912 samples/line (4 fsc)
+ *   ntsc_text64i : 64 x 56 characters interlaced (448 lines), 6x8 font
+ *   ntsc_graph128x96 : 128 x 96 pixels of 4 levels, pixels doubled both ways
+ *   ntsc_graph128x192 : 128 x 192 pixels of 4 levels, pixels doubled across
+ *
+ * Line period, sync widths, line count and picture area come from the
+ * timing profile video_now (video_timing.h: NTSC, PAL or PAL-M), selected
+ * by video_timing_init() before ntsc_video_init().
+ *
+ * Interlaced modes send 525 (625) lines per frame in two fields with the
+ * equalizing and serrated vertical sync pulses of the standard (half-line
+ * templates).  The upper field shows the even lines of the text and the
+ * other field the odd lines, so each line still builds a single row of
+ * glyphs.  ntsc_frame counts fields in these modes
+ * and ntsc_field is the parity of the field of the line being built.
+ *
+ * Text lines are built 4 characters (a word of VRAM) at a time: the SIO
+ * interpolators of the core turn the word into the addresses of the 4
+ * pre-expanded glyph rows, with no shifts and masks on the CPU.  The video
+ * engine owns interp0 and interp1 of the core taking the DMA interrupt.
+ *
+ * Raster handlers (raster.h) run before a line is built; ntsc_video_init()
+ * clears them, so register them after it.
+ *
+ * The DMA interrupt runs from RAM and reads only RAM: lines without a
+ * picture are sent straight from their templates, and the line buffers are
+ * written in the picture area only.
+ *
+ * The graphic modes show a packed graphic VRAM of gvram.h (2-bit level
+ * codes, 16 pixels per word) of cols x rows pixels, pointed to by
+ * ntsc_gvram before ntsc_video_init(), so gfx.h, gfont.h and blit.h draw on
+ * it.  The line is built from the row of the buffer: each pixel is char_w
+ * samples wide (a byte of 4 pixels is looked up in ntsc_double_lut[] as 8
+ * samples) and char_h lines high, so a 128x96 screen takes 3KB and a full
+ * redraw touches a quarter of the pixels of 256x192:
+ *
+ *   #define GVRAM_W 128
+ *   #define GVRAM_H 96
+ *   #include "gvram.h"
+ *   ...
+ *   ntsc_gvram = gvram[0];
+ *   ntsc_video_init(&ntsc_graph128x96);
+ *
+ * The clock divider is derived from the system clock at init.  The text
+ * VRAM is row-major, ntsc_text[y][x], like vram of the other programs;
+ * a character code + NTSC_INVERSE shows the character in black on white.
+ * Rows from ntsc_text_ring(first) to the bottom can be made a ring: the
+ * line builder shows them from the start row ntsc_ring_top, so
+ * ntsc_text_roll() scrolls them up by a row by moving the start row and
+ * clearing one row instead of copying the others.  The text functions take
+ * rows on the screen (NTSC_TEXT_Y()).
+ *
+ * ntsc_vblank_func, if set, is called by the DMA interrupt when the text
+ * area of a frame has been sent, for VRAM updates which must not tear
+ * (ntsc_console.h).
+ *
+ * The colour mode samples at 4 times the colour subcarrier (14.318 MHz),
+ * so the system clock must be a multiple of it: set_sys_clock_pll(
+ * NTSC_COLOR_VCO, NTSC_COLOR_PD1, NTSC_COLOR_PD2) gives 157.5 MHz = 11 x
+ * 4 fsc.  A line is 228 subcarrier cycles (like the Atari and Apple II,
+ * instead of 227.5), so the phase is the same on every line.  The colour
+ * burst is put on the back porch of the line templates, and a pixel is one
+ * cycle of 4 samples: ntsc_color_init() picks for each colour of the
+ * palette the pattern of 4 levels nearest to its luma and chroma, and a
+ * byte of two pixels is looked up in ntsc_color_lut[] as 8 samples.
+ * The colour mode encodes NTSC colour; it needs the NTSC profile.
+ *
+ *   ntsc_video_init(&ntsc_text64);
+ *   ntsc_text_strings(0, 0, "64 columns");
+ *   ntsc_wait_vblank();
+ */
+
+#ifndef __NTSC_VIDEO__
+#define __NTSC_VIDEO__
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/irq.h"
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+#include "hardware/clocks.h"
+#include "hardware/interp.h"
+#include "ntsc.pio.h"       // generated by pioasm
+#include "font8x8_basic.h"
+#include "font6x8_basic.h"
+#include "video_timing.h"   // NTSC, PAL and PAL-M
+#include "raster.h"         // raster callbacks
+
+#define NTSC_PIN        14      // GPIO14 (330 ohm), GPIO15 (1k ohm) is NTSC_PIN + 1
+#define NTSC_WORDS_MAX  128     // max words of a line buffer (2048 samples)
+#define NTSC_COLS_MAX   64      // max columns of text
+#define NTSC_ROWS_MAX   56      // max rows of text
+#define NTSC_CHAR_H_MAX 8       // max height of a character
+#define NTSC_SYNC       0       // level codes (GPIO15:GPIO14)
+#define NTSC_GRAY       1
+#define NTSC_BLACK      2
+#define NTSC_WHITE      3
+#define NTSC_INVERSE    0x80    // character code + NTSC_INVERSE: black on white
+#define NTSC_TEXT       0       // types of modes
+#define NTSC_COLOR      1
+#define NTSC_GRAPH      2
+#define NTSC_FSC_HZ     3579545 // colour subcarrier (315/88 MHz)
+#define NTSC_COLOR_VCO  1260000000  // PLL for 157.5 MHz system clock (44 fsc)
+#define NTSC_COLOR_PD1  4
+#define NTSC_COLOR_PD2  2
+#define NTSC_BURST_START    76  // first sample of colour burst (multiple of 4)
+#define NTSC_BURST_CYCLES   9   // cycles of colour burst
+#define NTSC_PIX_W      160     // colour frame buffer
+#define NTSC_PIX_H      192
+#define NTSC_COLORS     16
+#define NTSC_BLACK_MV   190     // output voltage of the levels (GPIO14 330 ohm, GPIO15 1k ohm)
+#define NTSC_GRAY_MV    575
+#define NTSC_WHITE_MV   765
+#define NTSC_GLYPH(interp, lane)    (*(const uint16_t *)interp_peek_lane_result(interp, lane))
+
+typedef struct {
+    const char *name;
+    int type;                   // NTSC_TEXT, NTSC_COLOR or NTSC_GRAPH
+    int interlace;              // 1: two fields of 262.5 lines, rows * char_h lines in total
+    int cols;                   // columns of text (multiple of 4; pixels in graphic modes)
+    int rows;                   // rows of text (lines of pixels in graphic modes)
+    int char_w;                 // width of a character (pixel: 1 or 2) [samples]
+    int char_h;                 // height of a character (pixel) [lines]
+    int samples;                // samples per line (multiple of 16)
+    int h_start;                // first sample of text (multiple of 16)
+    uint32_t sample_hz;         // sample clock, 0 = samples per line period of video_now
+    const unsigned char *font;  // glyph rows (char_h bytes per character, bit 0 = leftmost)
+    int font_first;             // first character of font
+    int font_num;               // number of characters of font
+} ntsc_mode;
+
+// row of the text VRAM shown at row y of the screen (rows of the ring moved by the start row)
+#define NTSC_TEXT_Y(y)  ((y) < ntsc_ring_first ? (y) : ntsc_ring_row(y))
+
+// not const: the DMA interrupt reads the mode from RAM
+ntsc_mode ntsc_text40 = {
+    "40x24", NTSC_TEXT, 0, 40, 24, 8, 8, 400, 64, 0, ascii_table[0], 0, ASCII_CHAR_NUM
+};
+ntsc_mode ntsc_text64 = {
+    "64x24", NTSC_TEXT, 0, 64, 24, FONT6X8_W, FONT6X8_H, 512, 80, 0,
+    font6x8[0], FONT6X8_FIRST, FONT6X8_NUM
+};
+ntsc_mode ntsc_text64i = {
+    "64x56i", NTSC_TEXT, 1, 64, 56, FONT6X8_W, FONT6X8_H, 512, 80, 0,
+    font6x8[0], FONT6X8_FIRST, FONT6X8_NUM
+};
+ntsc_mode ntsc_graph128x96 = {
+    "128x96", NTSC_GRAPH, 0, 128, 96, 2, 2, 320, 48, 0, NULL, 0, 0
+};
+ntsc_mode ntsc_graph128x192 = {
+    "128x192", NTSC_GRAPH, 0, 128, 192, 2, 1, 320, 48, 0, NULL, 0, 0
+};
+ntsc_mode ntsc_color160 = {
+    "160x192", NTSC_COLOR, 0, NTSC_PIX_W, NTSC_PIX_H, 4, 1, 912, 176, NTSC_FSC_HZ * 4, NULL, 0, 0
+};
+
+// palette of the colour mode (RGB, the colours of CGA)
+const uint8_t ntsc_palette_rgb[NTSC_COLORS][3] = {
+    {0, 0, 0}, {0, 0, 170}, {0, 170, 0}, {0, 170, 170},
+    {170, 0, 0}, {170, 0, 170}, {170, 85, 0}, {170, 170, 170},
+    {85, 85, 85}, {85, 85, 255}, {85, 255, 85}, {85, 255, 255},
+    {255, 85, 85}, {255, 85, 255}, {255, 255, 85}, {255, 255, 255}
+};
+
+const ntsc_mode *ntsc_mode_now;         // current video mode
+unsigned char __attribute__((aligned(4))) ntsc_text[NTSC_ROWS_MAX][NTSC_COLS_MAX];    // text VRAM (row-major, read by words)
+uint16_t ntsc_glyph[NTSC_CHAR_H_MAX][256];  // 2bpp glyph rows (white on black), line-major
+uint32_t ntsc_blank_line[NTSC_WORDS_MAX];   // line with horizontal sync only
+uint32_t ntsc_vsync_line[NTSC_WORDS_MAX];   // line of vertical sync
+uint32_t ntsc_vline[VIDEO_VL_NUM][NTSC_WORDS_MAX];  // half-line templates of interlaced modes
+uint32_t ntsc_buf[2][NTSC_WORDS_MAX];       // line buffers sent by DMA
+int ntsc_dma[2];                        // DMA channels of the line buffers
+int ntsc_words;                         // words per line
+uint32_t ntsc_clkdiv;                   // sample clock divider of the PIO (1/256)
+int ntsc_v_base;                        // first line of text (of a field)
+int ntsc_lines;                         // lines of a frame
+int ntsc_field_lines;                   // lines of text in a field
+int ntsc_end_line[2];                   // line of each field counting ntsc_frame
+volatile int ntsc_field = 0;            // field of the line being built (interlaced modes)
+int ntsc_next_line[2];                  // line to be built into each buffer
+volatile uint32_t ntsc_frame = 0;       // frame counter (counted at the end of text)
+int ntsc_ring_first = NTSC_ROWS_MAX;    // first row of the ring of rows (none)
+int ntsc_ring_rows = 0;                 // rows of the ring
+volatile int ntsc_ring_top = 0;         // row of the VRAM shown at ntsc_ring_first
+void (*volatile ntsc_vblank_func)( void ) = NULL;  // called at the end of the text area
+uint8_t ntsc_pix[NTSC_PIX_H][NTSC_PIX_W / 2];   // colour frame buffer (4 bits per pixel, even pixel low)
+uint8_t ntsc_color_pattern[NTSC_COLORS];    // 4 samples of each colour
+uint16_t ntsc_color_lut[256];           // two pixels -> 8 samples
+const uint32_t *ntsc_gvram;             // packed graphic VRAM of the graphic modes (gvram.h)
+uint16_t ntsc_double_lut[256];          // 4 pixels -> 8 samples (pixels doubled)
+
+// subcarrier at sample n (of 4 per cycle) is sin(n * 90 + 45 degrees): signs
+// of sin and cos; the burst is -sin
+const int8_t ntsc_sc_sin[4] = { 1, 1, -1, -1 };
+const int8_t ntsc_sc_cos[4] = { 1, -1, -1, 1 };
+
+// to set samples from..to-1 of a line to a level
+void ntsc_fill( uint32_t *line, int from, int to, int level ) {
+    for (int i = from; i < to; i++) {
+        int s = (i % 16) * 2;
+        line[i / 16] = (line[i / 16] & ~(3u << s)) | ((uint32_t)level << s);
+    }
+}
+
+// row of the VRAM shown at row y (>= ntsc_ring_first) of the screen
+int __not_in_flash_func(ntsc_ring_row)( int y ) {
+    y += ntsc_ring_top;
+    return (y >= ntsc_ring_first + ntsc_ring_rows) ? y - ntsc_ring_rows : y;
+}
+
+// to expand the font of the mode into 2bpp glyph rows (codes from
+// NTSC_INVERSE are the characters below it in black on white)
+void ntsc_font_expand( const ntsc_mode *m ) {
+    for (int i = 0; i < m->char_h; i++) {
+        for (int c = 0; c < 256; c++) {
+            int ch = c & ~NTSC_INVERSE;
+            int fg = (c & NTSC_INVERSE) ? NTSC_BLACK : NTSC_WHITE;
+            int bg = (c & NTSC_INVERSE) ? NTSC_WHITE : NTSC_BLACK;
+            unsigned char bits = 0;
+            if (ch >= m->font_first && ch < m->font_first + m->font_num) {
+                bits = m->font[(ch - m->font_first) * m->char_h + i];
+            }
+            uint16_t pix = 0;
+            for (int j = 0; j < m->char_w; j++) {
+                pix |= (((bits >> j) & 1) ? fg : bg) << (j * 2);
+            }
+            ntsc_glyph[i][c] = pix;
+        }
+    }
+}
+
+// to set the interpolators for the glyph rows of a word of text: lane 0
+// takes bits 1..8 of the accumulator (character 0 << 1, an index of
+// uint16_t) and lane 1 bits 9..16 of the same accumulator (character 1)
+void ntsc_interp_init( void ) {
+    interp_config c = interp_default_config();
+    interp_config_set_mask(&c, 1, 8);
+    interp_set_config(interp0, 0, &c);
+    interp_set_config(interp1, 0, &c);
+    interp_config_set_shift(&c, 8);
+    interp_config_set_cross_input(&c, true);
+    interp_set_config(interp0, 1, &c);
+    interp_set_config(interp1, 1, &c);
+}
+
+// to make the table doubling the pixels of a byte of packed pixels
+void ntsc_double_init( void ) {
+    for (int b = 0; b < 256; b++) {
+        uint16_t pix = 0;
+        for (int j = 0; j < 4; j++) {
+            pix |= ((b >> (j * 2)) & 3) * 5 << (j * 4);
+        }
+        ntsc_double_lut[b] = pix;
+    }
+}
+
+// half-line pulses of the vertical interval
+#define NTSC_HALF_NONE  0
+#define NTSC_HALF_H     1       // horizontal sync
+#define NTSC_HALF_EQ    2       // equalizing pulse
+#define NTSC_HALF_BROAD 3       // broad pulse
+
+// to set a half of a line (0 = first) to black with a pulse
+void ntsc_half_line( uint32_t *line, int half, int pulse, int samples ) {
+    int h = samples / 2, from = half * h;
+    int hsync = samples * video_now->sync_ns / video_now->line_ns;
+    int eq = samples * video_now->eq_ns / video_now->line_ns;
+    ntsc_fill(line, from, from + h, NTSC_BLACK);
+    if (pulse == NTSC_HALF_H) {
+        ntsc_fill(line, from, from + hsync, NTSC_SYNC);
+    } else if (pulse == NTSC_HALF_EQ) {
+        ntsc_fill(line, from, from + eq, NTSC_SYNC);
+    } else if (pulse == NTSC_HALF_BROAD) {
+        ntsc_fill(line, from, from + h - hsync, NTSC_SYNC);
+    }
+}
+
+// to make the line templates of the vertical interval of interlaced modes
+void ntsc_vline_init( int samples ) {
+    static const uint8_t pulse[VIDEO_VL_NUM][2] = {
+        {NTSC_HALF_EQ, NTSC_HALF_EQ}, {NTSC_HALF_BROAD, NTSC_HALF_BROAD},
+        {NTSC_HALF_EQ, NTSC_HALF_BROAD}, {NTSC_HALF_BROAD, NTSC_HALF_EQ},
+        {NTSC_HALF_EQ, NTSC_HALF_NONE}, {NTSC_HALF_H, NTSC_HALF_EQ}
+    };
+    for (int i = 0; i < VIDEO_VL_NUM; i++) {
+        ntsc_half_line(ntsc_vline[i], 0, pulse[i][0], samples);
+        ntsc_half_line(ntsc_vline[i], 1, pulse[i][1], samples);
+    }
+}
+
+// output voltage of a level code [mV]
+int ntsc_level_mv( int level ) {
+    static const int mv[4] = { 0, NTSC_GRAY_MV, NTSC_BLACK_MV, NTSC_WHITE_MV };
+    return mv[level];
+}
+
+// to choose the 4 samples of each colour of the palette: the pattern of
+// black, gray and white nearest to the luma and chroma (U, V) of the colour
+void ntsc_color_init( void ) {
+    const int level[3] = { NTSC_BLACK, NTSC_GRAY, NTSC_WHITE };
+    const int range = NTSC_WHITE_MV - NTSC_BLACK_MV;
+    for (int c = 0; c < NTSC_COLORS; c++) {
+        // Y, U, V of the colour [mV above black] (coefficients in Q10)
+        int r = ntsc_palette_rgb[c][0], g = ntsc_palette_rgb[c][1], b = ntsc_palette_rgb[c][2];
+        int y = (306 * r + 601 * g + 117 * b) >> 10;
+        int ty = y * range / 255;
+        int tu = (504 * (b - y) >> 10) * range / 255;
+        int tv = (898 * (r - y) >> 10) * range / 255;
+        int best = 0, best_err = -1;
+        for (int p = 0; p < 81; p++) {
+            // 4 samples of 3 levels, chroma by the same demodulation as a decoder:
+            // U = sum(v * sin) / 2, with |sin| = 0.707 (181 / 256)
+            int q = p, sy = 0, su = 0, sv = 0, pat = 0;
+            for (int n = 0; n < 4; n++, q /= 3) {
+                int v = ntsc_level_mv(level[q % 3]) - NTSC_BLACK_MV;
+                sy += v;
+                su += v * ntsc_sc_sin[n];
+                sv += v * ntsc_sc_cos[n];
+                pat |= level[q % 3] << (n * 2);
+            }
+            int ey = sy / 4 - ty, eu = su * 181 / 512 - tu, ev = sv * 181 / 512 - tv;
+            int err = ey * ey + (eu * eu + ev * ev) * 4;   // hue matters more than luma
+            if (best_err < 0 || err < best_err) {
+                best_err = err;
+                best = pat;
+            }
+        }
+        ntsc_color_pattern[c] = best;
+    }
+    for (int i = 0; i < 256; i++) {
+        ntsc_color_lut[i] = ntsc_color_pattern[i & 0xF] | (ntsc_color_pattern[i >> 4] << 8);
+    }
+}
+
+// to build a line of video into buf; returns the words to send: buf, or a
+// template for the lines without a picture (buf keeps the blank line outside
+// the picture, so only the picture is written)
+const uint32_t *__not_in_flash_func(ntsc_build_line)( uint32_t *buf, int line ) {
+    const ntsc_mode *m = ntsc_mode_now;
+    const video_timing *t = video_now;
+    int y;
+    if (m->interlace) {
+        ntsc_field = (line + 1 >= t->field_i);
+        // vertical interval, then the lines of text of the field: even lines
+        // in the upper field and odd lines in the other
+        for (int i = 0; i < t->vlines_num; i++) {
+            if (line + 1 >= t->vlines[i].first && line + 1 <= t->vlines[i].last) {
+                return ntsc_vline[t->vlines[i].vl];
+            }
+        }
+        y = line - ntsc_v_base - (ntsc_field ? t->field_i - 1 : 0);
+        y = (y < 0 || y >= ntsc_field_lines) ? -1 : y * 2 + (ntsc_field ^ t->field2_upper);
+    } else {
+        if (line + 1 >= t->vsync_first && line + 1 <= t->vsync_last) {
+            return ntsc_vsync_line;
+        }
+        y = line - ntsc_v_base;
+        y = (y < 0 || y >= ntsc_field_lines) ? -1 : y;
+    }
+    if (y < 0) {
+        return ntsc_blank_line;
+    }
+    if (m->type == NTSC_COLOR) {
+        // four pixels (32 samples) per word
+        const uint8_t *pix = ntsc_pix[y];
+        uint32_t *p = &buf[m->h_start / 16];
+        for (int x = 0; x < m->cols / 2; x += 2) {
+            *p++ = ntsc_color_lut[pix[x]] | ((uint32_t)ntsc_color_lut[pix[x + 1]] << 16);
+        }
+        return buf;
+    }
+    if (m->type == NTSC_GRAPH) {
+        // a row of the graphic VRAM for char_h lines
+        const uint32_t *pix = ntsc_gvram + (y / m->char_h) * (m->cols / 16);
+        uint32_t *p = &buf[m->h_start / 16];
+        if (m->char_w == 2) {
+            // 16 pixels to two words of doubled pixels
+            for (int x = 0; x < m->cols / 16; x++) {
+                uint32_t w = *pix++;
+                p[0] = ntsc_double_lut[w & 0xFF] | ((uint32_t)ntsc_double_lut[(w >> 8) & 0xFF] << 16);
+                p[1] = ntsc_double_lut[(w >> 16) & 0xFF] | ((uint32_t)ntsc_double_lut[w >> 24] << 16);
+                p += 2;
+            }
+        } else {
+            for (int x = 0; x < m->cols / 16; x++) {
+                *p++ = *pix++;
+            }
+        }
+        return buf;
+    }
+    // glyph rows of this line and characters of this text row, 4 characters
+    // per word: the interpolators give the addresses of their glyph rows
+    // (interp0 of characters 0 and 1, interp1 of characters 2 and 3)
+    const uint16_t *glyph = ntsc_glyph[y % m->char_h];
+    const uint32_t *text = (const uint32_t *)ntsc_text[NTSC_TEXT_Y(y / m->char_h)];
+    interp_set_base(interp0, 0, (uintptr_t)glyph);
+    interp_set_base(interp0, 1, (uintptr_t)glyph);
+    interp_set_base(interp1, 0, (uintptr_t)glyph);
+    interp_set_base(interp1, 1, (uintptr_t)glyph);
+    uint32_t *p = &buf[m->h_start / 16];
+    if (m->char_w == 8) {
+        // two characters per word
+        for (int x = 0; x < m->cols; x += 4) {
+            uint32_t w = *text++;
+            interp_set_accumulator(interp0, 0, w << 1);
+            interp_set_accumulator(interp1, 0, w >> 15);
+            p[0] = NTSC_GLYPH(interp0, 0) | ((uint32_t)NTSC_GLYPH(interp0, 1) << 16);
+            p[1] = NTSC_GLYPH(interp1, 0) | ((uint32_t)NTSC_GLYPH(interp1, 1) << 16);
+            p += 2;
+        }
+    } else {
+        // characters of any width: shift into a 64-bit accumulator
+        uint64_t acc = 0;
+        int bits = 0, w2 = m->char_w * 2;
+        for (int x = 0; x < m->cols; x += 4) {
+            uint32_t w = *text++;
+            interp_set_accumulator(interp0, 0, w << 1);
+            interp_set_accumulator(interp1, 0, w >> 15);
+            uint32_t g[4] = {
+                NTSC_GLYPH(interp0, 0), NTSC_GLYPH(interp0, 1),
+                NTSC_GLYPH(interp1, 0), NTSC_GLYPH(interp1, 1)
+            };
+            for (int i = 0; i < 4; i++) {
+                acc |= (uint64_t)g[i] << bits;
+                bits += w2;
+                if (bits >= 32) {
+                    *p++ = (uint32_t)acc;
+                    acc >>= 32;
+                    bits -= 32;
+                }
+            }
+        }
+        if (bits > 0) {
+            *p = (*p & (~0u << bits)) | (uint32_t)acc;
+        }
+    }
+    return buf;
+}
+
+// DMA interrupt: a line buffer has been sent; build the line after next into it
+void __not_in_flash_func(ntsc_dma_handler)( void ) {
+    for (int i = 0; i < 2; i++) {
+        if (!dma_channel_get_irq0_status(ntsc_dma[i])) {
+            continue;
+        }
+        dma_channel_acknowledge_irq0(ntsc_dma[i]);
+        int line = ntsc_next_line[i] + 2;
+        if (line >= ntsc_lines) {
+            line -= ntsc_lines;
+        }
+        ntsc_next_line[i] = line;
+        raster_run(line + 1);
+        // rewind the channel (started by the other channel at its end)
+        dma_channel_set_read_addr(ntsc_dma[i], ntsc_build_line(ntsc_buf[i], line), false);
+        // a frame (field) is counted when the text area has been sent
+        if (line == ntsc_end_line[0] || line == ntsc_end_line[1]) {
+            ntsc_frame++;
+            if (ntsc_vblank_func != NULL) {
+                ntsc_vblank_func();
+            }
+        }
+    }
+}
+
+// to clear text VRAM
+void ntsc_text_clear( void ) {
+    memset(ntsc_text, ' ', sizeof(ntsc_text));
+}
+
+// to write a character into text VRAM located at (x, y)
+void ntsc_text_write( int x, int y, unsigned char c ) {
+    if ((x < 0) || (x >= ntsc_mode_now->cols) || (y < 0) || (y >= ntsc_mode_now->rows)) {
+        return;
+    }
+    ntsc_text[NTSC_TEXT_Y(y)][x] = c;
+}
+
+// put strings on text VRAM
+void ntsc_text_strings( int x, int y, const char *mes ) {
+    for (; *mes != '\0'; mes++, x++) {
+        ntsc_text_write(x, y, (unsigned char)*mes);
+    }
+}
+
+// to scroll rows y0..y1 of text VRAM up by a row (row y1 is cleared)
+void ntsc_text_scroll( int y0, int y1 ) {
+    for (int y = y0; y < y1; y++) {
+        memcpy(ntsc_text[NTSC_TEXT_Y(y)], ntsc_text[NTSC_TEXT_Y(y + 1)], NTSC_COLS_MAX);
+    }
+    memset(ntsc_text[NTSC_TEXT_Y(y1)], ' ', NTSC_COLS_MAX);
+}
+
+// to make rows first..bottom of the screen a ring scrolled by ntsc_text_roll()
+void ntsc_text_ring( int first ) {
+    ntsc_ring_top = 0;
+    ntsc_ring_rows = ntsc_mode_now->rows - first;
+    ntsc_ring_first = first;
+}
+
+// to scroll the ring up by a row: the start row moves and the new bottom
+// row is cleared (a row of words, from the DMA interrupt too)
+void __not_in_flash_func(ntsc_text_roll)( void ) {
+    int top = ntsc_ring_top + 1;
+    ntsc_ring_top = (top >= ntsc_ring_rows) ? 0 : top;
+    uint32_t *p = (uint32_t *)ntsc_text[NTSC_TEXT_Y(ntsc_mode_now->rows - 1)];
+    for (int i = 0; i < NTSC_COLS_MAX / 4; i++) {
+        p[i] = 0x20202020;
+    }
+}
+
+// to set a pixel of the colour frame buffer
+void ntsc_color_pset( int x, int y, int c ) {
+    if ((x < 0) || (x >= NTSC_PIX_W) || (y < 0) || (y >= NTSC_PIX_H)) {
+        return;
+    }
+    uint8_t *p = &ntsc_pix[y][x >> 1];
+    *p = (x & 1) ? ((*p & 0x0F) | (c << 4)) : ((*p & 0xF0) | c);
+}
+
+// to fill a rectangle of the colour frame buffer
+void ntsc_color_fill_rect( int x, int y, int w, int h, int c ) {
+    for (int j = y; j < y + h; j++) {
+        for (int i = x; i < x + w; i++) {
+            ntsc_color_pset(i, j, c);
+        }
+    }
+}
+
+// to wait for the end of the text area of the next frame
+void ntsc_wait_vblank( void ) {
+    uint32_t frame = ntsc_frame;
+    while (frame == ntsc_frame) {
+#ifdef NTSC_HOST
+        host_run_lines(1);
+#else
+        __wfi();
+#endif
+    }
+}
+
+// to start video output in a mode
+void ntsc_video_init( const ntsc_mode *m ) {
+    ntsc_mode_now = m;
+    raster_init();
+    ntsc_ring_first = NTSC_ROWS_MAX;
+    ntsc_ring_top = 0;
+    ntsc_words = m->samples / 16;
+    const video_timing *t = video_now;
+    ntsc_lines = m->interlace ? t->lines_i : t->lines;
+    ntsc_field_lines = m->rows * m->char_h / (m->interlace ? 2 : 1);
+    ntsc_v_base = t->v_top - 1 + (t->v_visible - ntsc_field_lines) / 2;
+    ntsc_end_line[0] = ntsc_v_base + ntsc_field_lines + 1;
+    ntsc_end_line[1] = ntsc_end_line[0] + (m->interlace ? t->field_i - 1 : 0);
+    if (m->type == NTSC_COLOR) {
+        ntsc_color_init();
+        memset(ntsc_pix, 0, sizeof(ntsc_pix));
+    } else if (m->type == NTSC_GRAPH) {
+        ntsc_double_init();
+    } else {
+        ntsc_font_expand(m);
+        ntsc_interp_init();
+        ntsc_text_clear();
+    }
+
+    // line templates (samples of sync in proportion to the line period)
+    int sync = m->samples * t->sync_ns / t->line_ns;
+    ntsc_fill(ntsc_blank_line, 0, m->samples, NTSC_BLACK);
+    ntsc_fill(ntsc_blank_line, 0, sync, NTSC_SYNC);
+    if (m->type == NTSC_COLOR) {
+        // colour burst on the back porch: -sin, black and gray
+        for (int i = 0; i < NTSC_BURST_CYCLES * 4; i++) {
+            int n = NTSC_BURST_START + i;
+            ntsc_fill(ntsc_blank_line, n, n + 1, (ntsc_sc_sin[n % 4] < 0) ? NTSC_GRAY : NTSC_BLACK);
+        }
+    }
+    // vertical sync: two broad pulses per line
+    ntsc_fill(ntsc_vsync_line, 0, m->samples, NTSC_SYNC);
+    ntsc_fill(ntsc_vsync_line, m->samples / 2 - sync, m->samples / 2, NTSC_BLACK);
+    ntsc_fill(ntsc_vsync_line, m->samples - sync, m->samples, NTSC_BLACK);
+    if (m->interlace) {
+        ntsc_vline_init(m->samples);
+    }
+
+    // sample clock: sysclk / div = samples per line period, or sample_hz (div in 1/256)
+    uint32_t div;
+    if (m->sample_hz != 0) {
+        div = ((uint64_t)clock_get_hz(clk_sys) * 256 + m->sample_hz / 2) / m->sample_hz;
+    } else {
+        div = (uint64_t)clock_get_hz(clk_sys) * t->line_ns / 1000 * 256
+            / ((uint64_t)m->samples * 1000000);
+    }
+    ntsc_clkdiv = div;
+    PIO pio = pio0;
+    uint offset = pio_add_program(pio, &ntsc_out_program);
+    uint sm = pio_claim_unused_sm(pio, true);
+    ntsc_out_program_init(pio, sm, offset, NTSC_PIN, div >> 8, div & 0xFF);
+
+    // two DMA channels chained to each other, a line buffer each
+    ntsc_dma[0] = dma_claim_unused_channel(true);
+    ntsc_dma[1] = dma_claim_unused_channel(true);
+    for (int i = 0; i < 2; i++) {
+        ntsc_next_line[i] = i;
+        memcpy(ntsc_buf[i], ntsc_blank_line, sizeof(ntsc_buf[i]));
+        const uint32_t *words = ntsc_build_line(ntsc_buf[i], i);
+        dma_channel_config c = dma_channel_get_default_config(ntsc_dma[i]);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+        channel_config_set_read_increment(&c, true);
+        channel_config_set_write_increment(&c, false);
+        channel_config_set_dreq(&c, pio_get_dreq(pio, sm, true));
+        channel_config_set_chain_to(&c, ntsc_dma[1 - i]);
+        // ahead of bulk VRAM transfers (vdma.h) on the bus
+        channel_config_set_high_priority(&c, true);
+        dma_channel_configure(ntsc_dma[i], &c, &pio->txf[sm], words, ntsc_words, false);
+        dma_channel_set_irq0_enabled(ntsc_dma[i], true);
+    }
+    irq_set_exclusive_handler(DMA_IRQ_0, ntsc_dma_handler);
+    irq_set_enabled(DMA_IRQ_0, true);
+    dma_channel_start(ntsc_dma[0]);
+}
+
+#endif
@@ -0,0 +1,263 @@
+/**
+ * VT100 terminal on the scrolling console (ntsc_console.h) fed by a UART.
+ *
+ * A DMA channel paced by the RX DREQ of the UART writes the received bytes
+ * into a ring of VT_RING bytes (the ring mode of the channel wraps its
+ * write address), so no byte depends on the CPU answering in time; the
+ * video interrupt can hold it for a line and the UART FIFO is never read
+ * by an interrupt.  vt_poll() parses what has arrived since its last call
+ * (the bytes received are the transfers done by the channel) and applies
+ * it to the text VRAM, scrolls included.  It stops when VT_BUDGET_NS have
+ * passed (timed by the cycle counter of raster.h), so called right after
+ * ntsc_wait_vblank() its writes end within the vblank of every mode and the
+ * picture never shows half a scroll; the rest waits in the ring for the
+ * next frame.  At 921600 baud a frame brings about 1540 bytes, so polling
+ * once a frame leaves room in the ring; vt_overruns counts the bytes lost
+ * when it is polled too late.
+ *
+ *   ntsc_video_init(&ntsc_text64);
+ *   vt_init(uart0, VT_BAUD, 1, 2);      // RX on GP1, rows 2.. are the terminal
+ *   while (1) {
+ *       ntsc_wait_vblank();
+ *       vt_poll();
+ *   }
+ *
+ * Subset of VT100 / ANSI: CR, LF, BS, TAB, FF; ESC [ n A B C D (cursor),
+ * ESC [ r ; c H and f (position, rows of the terminal from 1), ESC [ n J
+ * and K (erase display / line, n = 0, 1, 2), ESC [ n m (0 normal, 7
+ * inverse, 27 not inverse), ESC [ s and u, ESC 7 and 8 (save / restore
+ * cursor), ESC D, E (index, next line) and ESC c (reset).  Other sequences
+ * are parsed and ignored; an ESC within a sequence starts a new one.
+ * Inverse uses the codes from NTSC_INVERSE.
+ *
+ * The channel counts down from VT_COUNT transfers (about 12 hours at
+ * 921600 baud) and is started again by vt_poll() when it is over.
+ */
+
+#ifndef __NTSC_VT__
+#define __NTSC_VT__
+
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/uart.h"
+#include "ntsc_video.h"
+#include "ntsc_console.h"
+
+#define VT_BAUD         921600
+#define VT_RING_BITS    12                  // ring of received bytes (4KB, aligned)
+#define VT_RING         (1 << VT_RING_BITS)
+#define VT_COUNT        0xFFFFFFFFu         // transfers of the channel
+#define VT_PARAMS       4                   // parameters of a control sequence
+#define VT_BUDGET_NS    1500000             // time of the parse per poll (within the vblank)
+#define VT_BUDGET_BYTES 16                  // bytes parsed between two looks at the time
+#define VT_ESC          0x1B
+#define VT_NORMAL       0                   // states of the parser
+#define VT_ESCAPE       1
+#define VT_CSI          2
+
+uint8_t __attribute__((aligned(VT_RING))) vt_ring[VT_RING];   // written by the DMA
+int vt_dma;                                 // DMA channel of the receiver
+uint32_t vt_base = 0;                       // bytes received by the former runs of the channel
+uint32_t vt_tail = 0;                       // bytes parsed
+uint32_t vt_overruns = 0;                   // bytes lost (not parsed in time)
+int vt_state = VT_NORMAL;
+int vt_param[VT_PARAMS];
+int vt_nparam;
+unsigned char vt_attr = 0;                  // added to printable characters (NTSC_INVERSE)
+int vt_save_x, vt_save_y;
+uint32_t vt_budget;                         // VT_BUDGET_NS in system clocks
+
+// bytes received by the channel
+uint32_t vt_received( void ) {
+    return vt_base + (VT_COUNT - dma_channel_hw_addr(vt_dma)->transfer_count);
+}
+
+// to erase columns x0..x1-1 of row y (of the screen)
+void vt_erase( int y, int x0, int x1 ) {
+    unsigned char *p = ntsc_text[NTSC_TEXT_Y(y)];
+    for (int x = x0; x < x1; x++) {
+        p[x] = ' ';
+    }
+}
+
+// to set the cursor within the terminal
+void vt_cursor( int x, int y ) {
+    int cols = ntsc_mode_now->cols, rows = ntsc_mode_now->rows;
+    con_x = (x < 0) ? 0 : (x >= cols) ? cols - 1 : x;
+    con_y = (y < con_first) ? con_first : (y >= rows) ? rows - 1 : y;
+}
+
+// to run the control sequence ESC [ params c
+void vt_csi( char c ) {
+    int n = (vt_nparam > 0 && vt_param[0] > 0) ? vt_param[0] : 1;
+    int p0 = (vt_nparam > 0) ? vt_param[0] : 0;
+    int cols = ntsc_mode_now->cols, rows = ntsc_mode_now->rows;
+    switch (c) {
+    case 'A':
+        vt_cursor(con_x, con_y - n);
+        break;
+    case 'B':
+        vt_cursor(con_x, con_y + n);
+        break;
+    case 'C':
+        vt_cursor(con_x + n, con_y);
+        break;
+    case 'D':
+        vt_cursor(con_x - n, con_y);
+        break;
+    case 'H':
+    case 'f':
+        vt_cursor(((vt_nparam > 1 && vt_param[1] > 0) ? vt_param[1] : 1) - 1, con_first + n - 1);
+        break;
+    case 'J':
+        if (p0 == 2) {
+            for (int y = con_first; y < rows; y++) vt_erase(y, 0, cols);
+        } else if (p0 == 1) {
+            for (int y = con_first; y < con_y; y++) vt_erase(y, 0, cols);
+            vt_erase(con_y, 0, con_x + 1);
+        } else {
+            vt_erase(con_y, con_x, cols);
+            for (int y = con_y + 1; y < rows; y++) vt_erase(y, 0, cols);
+        }
+        break;
+    case 'K':
+        if (p0 == 2) {
+            vt_erase(con_y, 0, cols);
+        } else if (p0 == 1) {
+            vt_erase(con_y, 0, con_x + 1);
+        } else {
+            vt_erase(con_y, con_x, cols);
+        }
+        break;
+    case 'm':
+        for (int i = 0; i < (vt_nparam > 0 ? vt_nparam : 1); i++) {
+            int a = (vt_nparam > 0) ? vt_param[i] : 0;
+            if (a == 0 || a == 27) {
+                vt_attr = 0;
+            } else if (a == 7) {
+                vt_attr = NTSC_INVERSE;
+            }
+        }
+        break;
+    case 's':
+        vt_save_x = con_x; vt_save_y = con_y;
+        break;
+    case 'u':
+        vt_cursor(vt_save_x, vt_save_y);
+        break;
+    }
+}
+
+// to parse a received byte
+void vt_putc( unsigned char c ) {
+    switch (vt_state) {
+    case VT_NORMAL:
+        if (c == VT_ESC) {
+            vt_state = VT_ESCAPE;
+        } else if (c >= 0x20 && c < 0x7F) {
+            con_putc(c | vt_attr);
+        } else if (c == '\n' || c == '\r' || c == '\b' || c == '\t' || c == '\f') {
+            con_putc(c);
+        }
+        break;
+    case VT_ESCAPE:
+        vt_state = VT_NORMAL;
+        if (c == '[') {
+            vt_state = VT_CSI;
+            vt_nparam = 0;
+            vt_param[0] = 0;
+        } else if (c == '7') {
+            vt_save_x = con_x; vt_save_y = con_y;
+        } else if (c == '8') {
+            vt_cursor(vt_save_x, vt_save_y);
+        } else if (c == 'D') {
+            int x = con_x;
+            con_newline();
+            con_x = x;
+        } else if (c == 'E') {
+            con_newline();
+        } else if (c == 'c') {
+            vt_attr = 0;
+            con_clear();
+        }
+        break;
+    case VT_CSI:
+        if (c == VT_ESC) {
+            // a new sequence
+            vt_state = VT_ESCAPE;
+        } else if (c >= '0' && c <= '9') {
+            if (vt_nparam == 0) vt_nparam = 1;
+            if (vt_nparam <= VT_PARAMS) {
+                vt_param[vt_nparam - 1] = vt_param[vt_nparam - 1] * 10 + (c - '0');
+            }
+        } else if (c == ';') {
+            if (vt_nparam == 0) vt_nparam = 1;
+            if (++vt_nparam <= VT_PARAMS) {
+                vt_param[vt_nparam - 1] = 0;
+            }
+        } else if (c >= 0x40 && c <= 0x7E) {
+            // final byte
+            if (vt_nparam > VT_PARAMS) vt_nparam = VT_PARAMS;
+            vt_csi(c);
+            vt_state = VT_NORMAL;
+        } else if (c < 0x20 || c > 0x3F) {
+            // not a control sequence ('?' and other parameter bytes are ignored)
+            vt_state = VT_NORMAL;
+        }
+        break;
+    }
+}
+
+// to parse the bytes received since the last call, within the budget;
+// returns their number
+int vt_poll( void ) {
+    if (!dma_channel_is_busy(vt_dma)) {
+        // the channel has done VT_COUNT transfers: run it again
+        vt_base += VT_COUNT;
+        dma_channel_set_trans_count(vt_dma, VT_COUNT, true);
+    }
+    uint32_t head = vt_received();
+    if (head - vt_tail > VT_RING) {
+        // the oldest bytes have been written over
+        vt_overruns += head - vt_tail - VT_RING;
+        vt_tail = head - VT_RING;
+    }
+    uint32_t start = raster_now();
+    int n = 0;
+    while (vt_tail != head) {
+        vt_putc(vt_ring[vt_tail++ % VT_RING]);
+        if (++n % VT_BUDGET_BYTES == 0 && ((raster_now() - start) & RASTER_CYCLE_MASK) >= vt_budget) {
+            break;
+        }
+    }
+    return n;
+}
+
+// to start the terminal from row first to the bottom, receiving from a UART
+void vt_init( uart_inst_t *uart, uint baud, uint rx_pin, int first ) {
+    con_first = first;
+    ntsc_text_ring(first);
+    con_clear();
+    vt_state = VT_NORMAL;
+    vt_attr = 0;
+    vt_save_x = 0;
+    vt_save_y = first;
+    vt_budget = (uint64_t)clock_get_hz(clk_sys) * VT_BUDGET_NS / 1000000000;
+    uart_init(uart, baud);
+    gpio_set_function(rx_pin, GPIO_FUNC_UART);
+    uart_set_fifo_enabled(uart, true);
+    // bytes of the receive FIFO to the ring, paced by the UART
+    vt_dma = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(vt_dma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, true, VT_RING_BITS);
+    channel_config_set_dreq(&c, uart_get_dreq(uart, false));
+    dma_channel_configure(vt_dma, &c, vt_ring, &uart_get_hw(uart)->dr, VT_COUNT, true);
+    vt_base = 0;
+    vt_tail = 0;
+    vt_overruns = 0;
+}
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * Raster callbacks: handlers run by the video interrupt before given lines.
+ *
+ * A game registers a cheap handler and the lines it runs on; the video
+ * interrupt calls it in the video context before the line is put out, so
+ * it can change what the scanline code reads (a font, an offset, a frame
+ * buffer) for a band of lines: a HUD in other colours, a split screen.
+ * Lines are numbered from 1 as in video_timing.h (count of the bit-banged
+ * programs); the bit-banged programs run the handler of the next line at
+ * the end of a line, and the PIO engine (ntsc_video.h) before building a
+ * line (two lines ahead).
+ *
+ *   int id = raster_add(hud_band, 400);    // budget 400 cycles
+ *   raster_set(V_BASE + 8, id);
+ *   ...
+ *   raster_run(count);                     // in the video interrupt
+ *
+ * Every call is timed in system clock cycles (SysTick, or the host clock
+ * scaled to clk_sys).  A handler taking more than its budget on
+ * RASTER_STRIKES calls in a row is disabled, so it can't break the sync;
+ * raster_handlers[] keeps its calls, longest call and overruns.  Handlers
+ * run from the interrupt and should be __not_in_flash_func() (add them to
+ * the roots of ntsc_ram_check()).
+ */
+
+#ifndef __RASTER__
+#define __RASTER__
+
+#include <stdint.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#ifdef NTSC_HOST
+#include <time.h>
+#else
+#include "hardware/structs/systick.h"
+#endif
+
+#define RASTER_MAX          8       // max handlers
+#define RASTER_LINES        626     // lines 1..625 (PAL interlaced)
+#define RASTER_STRIKES      3       // overruns in a row disabling a handler
+#define RASTER_CYCLE_MASK   0xFFFFFF    // SysTick is 24 bits
+
+typedef void (*raster_func)( int line );
+
+typedef struct {
+    raster_func func;
+    uint32_t budget;            // cycles allowed per call
+    bool enabled;
+    uint32_t calls;
+    uint32_t max_cycles;        // longest call
+    uint32_t overruns;          // calls over the budget
+    int strikes;                // overruns in a row
+} raster_handler;
+
+raster_handler raster_handlers[RASTER_MAX];
+int raster_num = 0;
+uint8_t raster_slot[RASTER_LINES];  // handler of each line + 1 (0: none)
+
+// cycle counter counting up (24 bits)
+uint32_t __not_in_flash_func(raster_now)( void ) {
+#ifdef NTSC_HOST
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t ns = (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+    return (uint32_t)(ns * (clock_get_hz(clk_sys) / 1000000) / 1000) & RASTER_CYCLE_MASK;
+#else
+    return RASTER_CYCLE_MASK - systick_hw->cvr;
+#endif
+}
+
+// to clear the table and start the cycle counter
+void raster_init( void ) {
+    memset(raster_handlers, 0, sizeof(raster_handlers));
+    memset(raster_slot, 0, sizeof(raster_slot));
+    raster_num = 0;
+#ifndef NTSC_HOST
+    systick_hw->rvr = RASTER_CYCLE_MASK;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5;      // enabled, processor clock, no interrupt
+#endif
+}
+
+// to register a handler with its budget in cycles; returns its id (-1 if full)
+int raster_add( raster_func func, uint32_t budget ) {
+    if (raster_num >= RASTER_MAX) {
+        return -1;
+    }
+    raster_handler *h = &raster_handlers[raster_num];
+    memset(h, 0, sizeof(*h));
+    h->func = func;
+    h->budget = budget;
+    h->enabled = true;
+    return raster_num++;
+}
+
+// to run handler id before a line (id -1: nothing)
+void raster_set( int line, int id ) {
+    if (line < 1 || line >= RASTER_LINES || id >= raster_num) {
+        return;
+    }
+    raster_slot[line] = (id < 0) ? 0 : id + 1;
+}
+
+// to run the handler of a line (from the video interrupt)
+void __not_in_flash_func(raster_run)( int line ) {
+    int s = raster_slot[line];
+    if (s == 0) {
+        return;
+    }
+    raster_handler *h = &raster_handlers[s - 1];
+    if (!h->enabled) {
+        return;
+    }
+    uint32_t start = raster_now();
+    h->func(line);
+    uint32_t cycles = (raster_now() - start) & RASTER_CYCLE_MASK;
+    h->calls++;
+    if (cycles > h->max_cycles) {
+        h->max_cycles = cycles;
+    }
+    if (cycles > h->budget) {
+        h->overruns++;
+        if (++h->strikes >= RASTER_STRIKES) {
+            h->enabled = false;
+        }
+    } else {
+        h->strikes = 0;
+    }
+}
+
+#endif
@@ -0,0 +1,226 @@
+/**
+ * Input recording and deterministic replay for the NTSC game programs.
+ *
+ * Every result of key_scan() is passed through replay_keys() and stored as
+ * run-length encoded words (key bits + repeat count) in RAM, together with
+ * the random seed given to replay_srand().  Games use replay_rand() instead
+ * of rand(), so the same seed and the same key sequence reproduce the same
+ * play on any build.
+ *
+ * Boot modes (keys held while power on, see replay_init()):
+ *   no key     : record from power on, saved to flash at game over
+ *   B button   : replay the log saved in flash, then return to live keys
+ *
+ * The games call replay_dump() after replay_save() at game over: it prints
+ * the log through stdio so that it can be captured and fed to other builds
+ * of the same game.  The host build (NTSC_HOST) replays a captured log given
+ * by the NTSC_REPLAY environment variable, and writes the log to the file
+ * named by NTSC_REPLAY_OUT at each game over and at the end of the run.
+ */
+
+#ifndef __REPLAY__
+#define __REPLAY__
+
+#include <stdio.h>
+#include <string.h>
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+
+#define REPLAY_MAGIC        0x52504C59  // "RPLY"
+#define REPLAY_FLASH_SIZE   (16 * 1024) // flash area for a saved log
+#define REPLAY_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - REPLAY_FLASH_SIZE)
+#define REPLAY_HEAD_WORDS   4           // magic, seed, length, checksum
+#define REPLAY_MAX_ENTRIES  (REPLAY_FLASH_SIZE / 4 - REPLAY_HEAD_WORDS)
+#ifndef REPLAY_KEY_SHIFT
+#define REPLAY_KEY_SHIFT    6           // lowest key GPIO (BKEYGP)
+#endif
+#define REPLAY_KEY_BITS     6           // number of keys
+#define REPLAY_KEY_MASK     ((1 << REPLAY_KEY_BITS) - 1)
+#define REPLAY_RUN_MAX      ((1 << (32 - REPLAY_KEY_BITS)) - 1)
+
+enum ReplayMode {REPLAY_OFF, REPLAY_RECORD, REPLAY_PLAY, REPLAY_FULL};  // FULL: recorded log is full
+
+typedef struct {
+    uint32_t magic;     // REPLAY_MAGIC if the log is valid
+    uint32_t seed;      // random seed given to replay_srand()
+    uint32_t length;    // number of used entries
+    uint32_t checksum;  // sum of seed, length and all entries
+    uint32_t entry[REPLAY_MAX_ENTRIES]; // (run << REPLAY_KEY_BITS) | keys
+} replay_log_t;
+
+replay_log_t replay_log;                // log in RAM
+enum ReplayMode replay_mode = REPLAY_OFF;
+uint32_t replay_pos = 0;                // entry index while replaying
+uint32_t replay_run = 0;                // remaining repeats of the entry
+uint32_t replay_rand_state = 1;         // state of replay_rand()
+
+// calculate checksum of the log
+uint32_t replay_checksum( replay_log_t *log ) {
+    uint32_t sum = log->seed + log->length;
+    for (uint32_t i = 0; i < log->length && i < REPLAY_MAX_ENTRIES; i++) {
+        sum += log->entry[i];
+    }
+    return sum;
+}
+
+// check if the log has a valid header and checksum
+bool replay_valid( replay_log_t *log ) {
+    return (log->magic == REPLAY_MAGIC) && (log->length <= REPLAY_MAX_ENTRIES)
+        && (log->checksum == replay_checksum(log));
+}
+
+// start recording (REPLAY_RECORD) or replaying (REPLAY_PLAY)
+void replay_start( enum ReplayMode mode ) {
+    if (mode == REPLAY_PLAY && !replay_valid(&replay_log)) {
+        mode = REPLAY_RECORD;
+    }
+    if (mode == REPLAY_RECORD) {
+        replay_log.magic = REPLAY_MAGIC;
+        replay_log.seed = 0;
+        replay_log.length = 0;
+    }
+    replay_pos = 0;
+    replay_run = 0;
+    replay_mode = mode;
+}
+
+// load the log saved in flash into RAM; returns false if there is none
+bool replay_load( void ) {
+    const replay_log_t *saved = (const replay_log_t *)(XIP_BASE + REPLAY_FLASH_OFFSET);
+    if (saved->magic != REPLAY_MAGIC || saved->length > REPLAY_MAX_ENTRIES) {
+        return false;
+    }
+    memcpy(&replay_log, saved, REPLAY_HEAD_WORDS * 4 + saved->length * 4);
+    return replay_valid(&replay_log);
+}
+
+// save the recorded log into flash (video is stopped while erasing)
+void replay_save( void ) {
+    if (replay_mode != REPLAY_RECORD && replay_mode != REPLAY_FULL) {
+        return;
+    }
+    replay_log.checksum = replay_checksum(&replay_log);
+    uint32_t size = REPLAY_HEAD_WORDS * 4 + replay_log.length * 4;
+    size = (size + FLASH_PAGE_SIZE - 1) & ~(FLASH_PAGE_SIZE - 1);
+    uint32_t ints = save_and_disable_interrupts();
+    flash_range_erase(REPLAY_FLASH_OFFSET, REPLAY_FLASH_SIZE);
+    flash_range_program(REPLAY_FLASH_OFFSET, (const uint8_t *)&replay_log, size);
+    restore_interrupts(ints);
+}
+
+// print the log through stdio ("RPLY seed length" then one entry per line);
+// the host build writes it to the file named by NTSC_REPLAY_OUT instead
+void replay_dump( void ) {
+    FILE *fp = stdout;
+#ifdef NTSC_HOST
+    char *path = getenv("NTSC_REPLAY_OUT");
+    if (path == NULL || (fp = fopen(path, "w")) == NULL) {
+        return;
+    }
+#endif
+    fprintf(fp, "RPLY %lu %lu\n", (unsigned long)replay_log.seed, (unsigned long)replay_log.length);
+    for (uint32_t i = 0; i < replay_log.length; i++) {
+        fprintf(fp, "%08lx\n", (unsigned long)replay_log.entry[i]);
+    }
+#ifdef NTSC_HOST
+    fclose(fp);
+#endif
+}
+
+#ifdef NTSC_HOST
+// load a log printed by replay_dump(); returns false if it can't be read
+bool replay_load_file( const char *path ) {
+    FILE *fp = fopen(path, "r");
+    unsigned long seed, length, entry;
+    if (fp == NULL) {
+        return false;
+    }
+    replay_log.length = 0;
+    if (fscanf(fp, "RPLY %lu %lu", &seed, &length) == 2) {
+        replay_log.seed = seed;
+        while (replay_log.length < length && replay_log.length < REPLAY_MAX_ENTRIES
+            && fscanf(fp, "%lx", &entry) == 1) {
+            replay_log.entry[replay_log.length++] = entry;
+        }
+    }
+    fclose(fp);
+    replay_log.magic = REPLAY_MAGIC;
+    replay_log.checksum = replay_checksum(&replay_log);
+    return replay_log.length > 0;
+}
+#endif
+
+// select mode by keys held at power on (keys = result of key_scan())
+void replay_init( uint32_t keys ) {
+#ifdef NTSC_HOST
+    // the log of the whole run is written out at exit
+    atexit(replay_dump);
+    char *path = getenv("NTSC_REPLAY");
+    if (path != NULL && replay_load_file(path)) {
+        replay_start(REPLAY_PLAY);
+        return;
+    }
+#endif
+    if (((keys >> REPLAY_KEY_SHIFT) & 1) != 0 && replay_load()) {
+        replay_start(REPLAY_PLAY);
+    } else {
+        replay_start(REPLAY_RECORD);
+    }
+}
+
+// record or replay one key scan; returns keys the game should use
+uint32_t replay_keys( uint32_t keys ) {
+    uint32_t k = (keys >> REPLAY_KEY_SHIFT) & REPLAY_KEY_MASK;
+    uint32_t n = replay_log.length;
+
+    if (replay_mode == REPLAY_RECORD) {
+        // extend the last run if the keys are not changed
+        if (n > 0 && (replay_log.entry[n - 1] & REPLAY_KEY_MASK) == k
+            && (replay_log.entry[n - 1] >> REPLAY_KEY_BITS) < REPLAY_RUN_MAX) {
+            replay_log.entry[n - 1] += 1 << REPLAY_KEY_BITS;
+        // else start a new run
+        } else if (n < REPLAY_MAX_ENTRIES) {
+            replay_log.entry[n] = (1 << REPLAY_KEY_BITS) | k;
+            replay_log.length++;
+        // if the log is full, keep the log (saved by replay_save()) and stop recording
+        } else {
+            replay_mode = REPLAY_FULL;
+        }
+    } else if (replay_mode == REPLAY_PLAY) {
+        // fetch next run
+        if (replay_run == 0) {
+            // if the log ends, return to live keys
+            if (replay_pos >= replay_log.length) {
+                replay_mode = REPLAY_OFF;
+                return keys;
+            }
+            replay_run = replay_log.entry[replay_pos] >> REPLAY_KEY_BITS;
+            replay_pos++;
+        }
+        replay_run--;
+        return (replay_log.entry[replay_pos - 1] & REPLAY_KEY_MASK) << REPLAY_KEY_SHIFT;
+    }
+    return keys;
+}
+
+// set random seed; in replay mode the recorded seed is used instead
+void replay_srand( uint32_t seed ) {
+    if (replay_mode == REPLAY_PLAY) {
+        seed = replay_log.seed;
+    } else if (replay_mode == REPLAY_RECORD) {
+        replay_log.seed = seed;
+    }
+    replay_rand_state = (seed != 0) ? seed : 1;
+}
+
+// portable random number generator (xorshift32), 0..0x7FFFFFFF
+int replay_rand( void ) {
+    uint32_t x = replay_rand_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    replay_rand_state = x;
+    return (int)(x >> 1);
+}
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * Per-line horizontal fine scroll for the text-mode programs.
+ *
+ * scroll_x[l] is the offset in pixels (0..CHAR_W-1) of line l of the text
+ * area.  The scanline starts the line at that pixel of its first character
+ * and ends it with as many black pixels, so the line keeps its width and
+ * timing:
+ *
+ *   int fine = scroll_x[count - V_BASE];
+ *   uint32_t pix = row[text[0]] >> (fine * 2);     // first character from pixel fine
+ *   ...
+ *
+ * A band of rows slides left by a pixel with an update of its offsets only
+ * (scroll_rows()); bands with different offsets give parallax.  After
+ * CHAR_W - 1 pixels the game moves the characters a column left and sets
+ * the offset back to 0.
+ *
+ * A character which has to keep still on a scrolled row (the player) is
+ * drawn as a pair of codes, whose glyphs scroll_glyph() makes from the
+ * character shifted right by the offset, cancelling the scroll.  The font
+ * is the RAM table of pre-expanded pixel levels (fontgen -m 2bpp -r).
+ */
+
+#ifndef __SCROLL__
+#define __SCROLL__
+
+#include <stdint.h>
+#include "font8x8_basic.h"
+#include "font8x8_2bpp.h"
+
+#define SCROLL_LINES    (VRAM_H * CHAR_H)   // lines of the text area (VRAM_H of the program)
+#define SCROLL_FG       3       // levels of scroll_glyph() (white on black)
+#define SCROLL_BG       2
+
+uint8_t scroll_x[SCROLL_LINES];     // fine offset of each line [pixels]
+
+// to set the offset of the lines of text rows y0..y1
+void scroll_rows( int y0, int y1, int x ) {
+    for (int l = y0 * CHAR_H; l < (y1 + 1) * CHAR_H; l++) {
+        scroll_x[l] = x;
+    }
+}
+
+// pixel levels of 8 pixels of glyph bits (bit 0 = leftmost)
+uint16_t scroll_expand( uint32_t bits ) {
+    uint16_t pix = 0;
+    for (int j = 0; j < CHAR_W; j++) {
+        pix |= (((bits >> j) & 1) ? SCROLL_FG : SCROLL_BG) << (j * 2);
+    }
+    return pix;
+}
+
+// to make codes left and right character c shifted right by x pixels
+void scroll_glyph( int left, int right, unsigned char c, int x ) {
+    for (int i = 0; i < CHAR_H; i++) {
+        uint32_t bits = (uint32_t)ascii_table[c][i] << x;
+        font8x8_2bpp[i][left] = scroll_expand(bits & 0xFF);
+        font8x8_2bpp[i][right] = scroll_expand(bits >> CHAR_W);
+    }
+}
+
+#endif
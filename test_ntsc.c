@@ -8,10 +8,14 @@
 #include "pico/stdlib.h"
 #include "hardware/irq.h"
 #include "hardware/pwm.h"
+#include "video_timing.h"     // NTSC, PAL and PAL-M
 #include "hardware/adc.h"
 #include "font8x8_basic.h"
+#include "hud.h"
+#include "vdma.h"             // VRAM clear by DMA
 
-#define CONV_FACTOR (3.3f / (1 << 12)) // ADC data -> voltage (white Pico)
+#define CONV_MVOLT  3300    // ADC data * CONV_MVOLT >> 12 -> voltage in mV (white Pico)
+#define TEMP_SLOPE  5950    // 1024 * 10 / 1.721 (0.1 degree per mV, Q10)
 #define ADC_TEMP    4 // temperature sensor input
 #define LED     25      // GPIO connected LED on the board
 #define MLED    (1 << LED)
@@ -28,10 +32,10 @@
 #define GRAY    gpio_put_masked((M14 | M15), M14)           // GPIO14='H' and GPIO15='L'
 #define VRAM_W  20      // width size of VRAM
 #define VRAM_H  20      // height size of VRAM
-#define V_BASE  40      // horizontal line number to start displaying VRAM
+#define V_BASE  (40 + video_v_shift)  // horizontal line number to start displaying VRAM (NTSC)
 #define BAR_MAX 20      // bar length
 
-volatile unsigned char vram[VRAM_W][VRAM_H]; // VRAM
+volatile unsigned char vram[VRAM_H][VRAM_W]; // VRAM (row-major)
 int count = 1;                      // horizontal line counter
 int count_vsync = 0;
 int bx = 0; int by = 0;
@@ -40,24 +44,32 @@ int buf_len = 1;
 volatile bool state = true;
 int bar_len = 0;
 bool bar_inc = true;
+// line-major copy of ascii_table: glyph_row[cline][c] = ascii_table[c][cline]
+unsigned char __scratch_x("glyph_row") glyph_row[CHAR_H][ASCII_CHAR_NUM];
 
-// to clear VRAM contents (set to 0)
-void vram_clear( void ) {
-    for (int i = 0; i < VRAM_W; i++) {
-        for (int j = 0; j < VRAM_H; j++) {
-            vram[i][j] = 0;
+// copy ascii_table into glyph_row, so a scanline reads one contiguous row
+void glyph_row_init( void ) {
+    for (int c = 0; c < ASCII_CHAR_NUM; c++) {
+        for (int i = 0; i < CHAR_H; i++) {
+            glyph_row[i][c] = ascii_table[c][i];
         }
     }
 }
 
+// to clear VRAM contents (set to 0) by DMA
+void vram_clear( void ) {
+    vdma_fill(vram, 0, sizeof(vram));
+    vdma_wait();
+}
+
 // to write a value into VRAM located at (x, y)
 void vram_write ( int x, int y, unsigned char value ) {
-    vram[x][y] = value;
+    vram[y][x] = value;
 }
 
 // to read a value from VRAM located at (x, y)
 unsigned char vram_read( int x, int y) {
-    return vram[x][y];
+    return vram[y][x];
 }
 
 // to write strings into VRAM located at (x, y)
@@ -73,7 +85,7 @@ void vram_strings( int x, int y, char *mes) {
             return;
         // else put a character at the position
         } else {
-            vram[x + i][y] = mes[i];
+            vram[y][x + i] = mes[i];
         }
     }
     return;
@@ -109,18 +121,17 @@ void flip_led( void ) {
 // measure Temperature and display
 void measure_temp( int line ) {
     uint16_t temp_dat;
-    float voltage, temp;
-    char mes[VRAM_W];
+    int mvolt, temp10;
     // read ADC(temperature) data
     temp_dat = adc_read();
-    // convert ADC data to voltage
-    voltage = temp_dat * CONV_FACTOR;
-    // convert voltage to temperature
-    temp = 27 - (voltage - 0.706) / 0.001721;
-    // make massage from voltage and temp
-    sprintf(mes, "V=%2.3f T=%2.1f", voltage, temp);
-    // display voltage and temp
-    vram_strings(0, line, mes);
+    // convert ADC data to voltage (mV)
+    mvolt = (temp_dat * CONV_MVOLT) >> 12;
+    // convert voltage to temperature (0.1 degree)
+    temp10 = 270 - (((mvolt - 706) * TEMP_SLOPE) >> 10);
+    // display voltage and temp as "V=0.706 T= 27.0"
+    vram_strings(0, line, "V=      T=");
+    hud_number(2, line, 5, 3, mvolt, vram_write);
+    hud_number(10, line, 5, 1, temp10, vram_write);
 }
 
 // sisplay given message at random place
@@ -139,39 +150,36 @@ void display_message_at_random_place( char *buf ) {
 }
 
 // to generate horizontal sync siganl
-void hsync( void ) {
+void __not_in_flash_func(hsync)( void ) {
     SYNC;
-    sleep_us(5);
+    video_wait_cycles(video_sync_cycles);
     BLACK;
-    sleep_us(7);
+    video_wait_cycles(video_porch_cycles);
 }
 
 // to generate vertical sync siganl
-void vsync ( void ) {
+void __not_in_flash_func(vsync)( void ) {
+    // two broad pulses of half a line, a serration of hsync width between
     SYNC;
-    sleep_us(10);
-    sleep_us(5);
-    sleep_us(10);
+    video_wait_cycles(video_broad_cycles);
     BLACK;
-    sleep_us(5);
+    video_wait_cycles(video_sync_cycles);
 
     SYNC;
-    sleep_us(10);
-    sleep_us(5);
-    sleep_us(10);
+    video_wait_cycles(video_broad_cycles);
     BLACK;
-    sleep_us(5);
+    // the second serration lasts until the next line interrupt
 
     count_vsync++;
 }
 
 // handler for holizontal line processing
-void horizontal_line( ) {
+void __not_in_flash_func(horizontal_line)( ) {
     // Clear the interrupt flag that brought us here
     pwm_clear_irq(pwm_gpio_to_slice_num(GPPWM));
 
     // vertical synchronization duration
-    if (count >= 3 && count <= 5) {
+    if (count >= video_now->vsync_first && count <= video_now->vsync_last) {
         vsync();    // vertical SYNC
 
     // VRAM drawing area
@@ -179,17 +187,22 @@ void horizontal_line( ) {
         hsync();
         // left blank??
         BLACK;
-        sleep_us(0);    // should be tuned
+        video_wait_us(0);    // should be tuned
 
         // calculate VRAM y position from scan line number
         int y = (count - V_BASE) / CHAR_H;
+        int cline = (count - V_BASE) % CHAR_H;
+        // glyph rows of all characters for this line
+        const unsigned char *row = glyph_row[cline];
+        // characters of this text row (contiguous)
+        const volatile unsigned char *text = vram[y];
         // horizontal VRAM drawing
         for (int x = 0; x < VRAM_W; x++) {
-            // read VRAM
-            volatile unsigned char c = vram[x][y];
-            // draw bit from character table (ascii_table)
+            // read VRAM and the glyph row of the character
+            unsigned char bits = row[text[x]];
+            // draw bit from the glyph row
             for (int w = 0; w < CHAR_W; w++) {
-                if ((ascii_table[c][count % CHAR_H] & (1 << w)) != 0) {
+                if ((bits & (1 << w)) != 0) {
                     GRAY; WHITE;
                 } else {
                     BLACK; BLACK;
@@ -199,8 +212,8 @@ void horizontal_line( ) {
 
 /*
         WHITE;
-        sleep_us(10);
-        sleep_us(10);
+        video_wait_us(10);
+        video_wait_us(10);
 */
         // right blank??
         BLACK;
@@ -211,7 +224,7 @@ void horizontal_line( ) {
     // count up scan line 
     count++;
     // if scan line reach to max
-    if (count > 262) {
+    if (count > video_now->lines) {
         count = 1;
     }
     return;
@@ -229,6 +242,9 @@ int main() {
     gpio_init(LED);
     gpio_init_mask(MLED);
     gpio_set_dir(LED, GPIO_OUT);
+    // select NTSC, PAL or PAL-M by the strap pins (and set the system clock
+    // before the peripherals take their dividers from it)
+    video_timing_init();
     // init stdio
     stdio_init_all();
     // init ADC
@@ -237,6 +253,10 @@ int main() {
     adc_set_temp_sensor_enabled(true);
     // select ADC input
     adc_select_input(ADC_TEMP);    // ADC selected
+    // copy font into RAM for the scanline loop
+    glyph_row_init();
+    // claim the DMA channel of VRAM operations
+    vdma_init(true);
     // clear VRAM
     vram_clear();
 
@@ -256,7 +276,7 @@ int main() {
     // counter is allowed to wrap over its maximum range (0 to 2**16-1)
     pwm_config config = pwm_get_default_config();
     // Set counter wrap value to generate PWM interrupt by this value
-    pwm_set_wrap(slice_num, 7999);
+    pwm_set_wrap(slice_num, video_pwm_wrap());
     // Load the configuration into our PWM slice, and set it running.
     pwm_set_enabled(slice_num, true);
 
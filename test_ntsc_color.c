@@ -0,0 +1,112 @@
+/**
+ * Test program for NTSC signal generation.
+ * Colour mode of the PIO video engine (ntsc_video.h): colour burst and
+ * 16 colours, 160 x 192 pixels.  Bars of the palette and a bouncing box.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "ntsc_video.h"
+#include "hud.h"
+#define BENCH_TICKS 600 // frames of the host benchmark
+#include "bench.h"
+
+#define LED     25      // GPIO connected LED on the board
+#define MLED    (1 << LED)
+#define LEDON   gpio_put_masked(MLED, MLED)
+#define LEDOFF  gpio_put_masked(MLED, 0)
+#define BAR_Y   24      // bars of the palette
+#define BAR_W   10
+#define BAR_H   64
+#define BOX_Y   112     // area of the bouncing box
+#define BOX_H   72
+#define BOX_SIZE    12
+
+volatile bool state = true;
+
+// flip LED
+void flip_led( void ) {
+    if (state == true) {
+        LEDON;
+    } else {
+        LEDOFF;
+    }
+    state = !state;
+}
+
+// put a character of the 8x8 font at (x, y) in pixels
+void color_put_char( int x, int y, unsigned char c, int fg, int bg ) {
+    if (c >= ASCII_CHAR_NUM) {
+        c = ' ';
+    }
+    for (int i = 0; i < CHAR_H; i++) {
+        unsigned char bits = ascii_table[c][i];
+        for (int j = 0; j < CHAR_W; j++) {
+            ntsc_color_pset(x + j, y + i, ((bits >> j) & 1) ? fg : bg);
+        }
+    }
+}
+
+// put a character of hud (x in characters, y in pixels)
+void color_hud_put( int x, int y, unsigned char c ) {
+    color_put_char(x * CHAR_W, y, c, 14, 0);
+}
+
+// put strings (x in characters, y in pixels)
+void color_strings( int x, int y, const char *mes, int fg ) {
+    for (; *mes != '\0'; mes++, x++) {
+        color_put_char(x * CHAR_W, y, (unsigned char)*mes, fg, 0);
+    }
+}
+
+int main() {
+    // system clock of 11 x 4 fsc for the colour mode
+    set_sys_clock_pll(NTSC_COLOR_VCO, NTSC_COLOR_PD1, NTSC_COLOR_PD2);
+    // init stdio
+    stdio_init_all();
+    // initialize LED GPIO
+    gpio_init(LED);
+    gpio_init_mask(MLED);
+    gpio_set_dir(LED, GPIO_OUT);
+
+    ntsc_video_init(&ntsc_color160);
+
+    color_strings(0, 0, "NTSC COLOUR", 15);
+    color_strings(0, 10, "FRAME", 7);
+    hud_field hud_frame;
+    hud_init(&hud_frame, 6, 10, 8, color_hud_put);
+    // bars of the palette with their numbers
+    for (int c = 0; c < NTSC_COLORS; c++) {
+        ntsc_color_fill_rect(c * BAR_W, BAR_Y, BAR_W, BAR_H, c);
+        color_put_char(c * BAR_W + 1, BAR_Y + BAR_H + 2, "0123456789ABCDEF"[c], 7, 0);
+    }
+    ntsc_color_fill_rect(0, BOX_Y - 1, NTSC_PIX_W, 1, 8);
+    ntsc_color_fill_rect(0, BOX_Y + BOX_H, NTSC_PIX_W, 1, 8);
+
+    int bx = 0, by = BOX_Y, dx = 1, dy = 1, col = 1;
+    while (1) {
+        // move the box once per frame
+        ntsc_wait_vblank();
+        hud_set(&hud_frame, ntsc_frame);
+        ntsc_color_fill_rect(bx, by, BOX_SIZE, BOX_SIZE, 0);
+        bx += dx;
+        by += dy;
+        if (bx <= 0 || bx >= NTSC_PIX_W - BOX_SIZE) {
+            dx = -dx;
+            col = (col % (NTSC_COLORS - 1)) + 1;
+        }
+        if (by <= BOX_Y || by >= BOX_Y + BOX_H - BOX_SIZE) {
+            dy = -dy;
+        }
+        ntsc_color_fill_rect(bx, by, BOX_SIZE, BOX_SIZE, col);
+        if (ntsc_frame % 60 == 0) {
+            // flip LED
+            flip_led();
+        }
+        // count a tick of the host benchmark
+        BENCH_TICK();
+    }
+
+    return 0;
+}
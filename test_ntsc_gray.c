@@ -0,0 +1,276 @@
+/**
+ * Test program for NTSC signal generation.
+ * 16 shades of gray by ordered and temporal dithering (dither.h) on the
+ * resistor ladder: bars of the shades, a moving gradient and a shaded ball.
+ * Define DAC3 for a 3-bit ladder with GPIO16 (2.2k ohm) added.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/irq.h"
+#include "hardware/pwm.h"
+#include "video_timing.h"     // NTSC, PAL and PAL-M
+#include "font8x8_basic.h"
+
+#define LED     25      // GPIO connected LED on the board
+#define MLED    (1 << LED)
+#define LEDON   gpio_put_masked(MLED, MLED)
+#define LEDOFF  gpio_put_masked(MLED, 0)
+#define GPPWM   2       // GPIO2 is PWM output
+#define GP14    14      // GPIO14 connected to RCA+ pin via 330 ohm
+#define GP15    15      // GPIO15 connected to RCA+ pin via 1k ohm
+#define GP16    16      // GPIO16 connected to RCA+ pin via 2.2k ohm (DAC3 only)
+#define M14     (1 << GP14) // bit mask for GPIO14
+#define M15     (1 << GP15) // bit mask for GPIO15
+#define M16     (1 << GP16) // bit mask for GPIO16
+//#define DAC3              // 3-bit ladder: GPIO14, GPIO15 and GPIO16
+#ifdef DAC3
+#define DAC_MASK    (M14 | M15 | M16)
+#define DAC_OHMS    {330, 1000, 2200}
+#else
+#define DAC_MASK    (M14 | M15)
+#define DAC_OHMS    {330, 1000}
+#endif
+#define DAC_SHIFT   GP14
+#define LEVEL(v)    gpio_put_masked(DAC_MASK, (v) << DAC_SHIFT)    // DAC code
+#define SYNC    LEVEL(0)
+#define BLACK   LEVEL(dac_level[0])
+#define SFB_W   256     // width of shade frame buffer
+#define SFB_H   192     // height of shade frame buffer
+#define V_BASE  (48 + video_v_shift)  // horizontal line number to start displaying the frame buffer (NTSC)
+#define BAR_Y   12      // bars of the shades
+#define BAR_H   32
+#define MV_Y    60      // voltages of the levels
+#define RAMP_Y  76      // moving gradient
+#define RAMP_H  16
+#define BALL_X  128     // shaded ball
+#define BALL_Y  146
+#define BALL_R  44
+
+#include "dither.h"     // ordered dithering (needs DAC_MASK, DAC_SHIFT and DAC_OHMS)
+#include "hud.h"        // numbers without printf
+#include "bench.h"
+
+int count = 1;                      // horizontal line counter
+volatile uint32_t frame = 0;        // frame counter (phase of the dither)
+volatile bool state = true;
+int ramp_phase = 0;
+uint8_t sfb[SFB_H][SFB_W / 2];      // shade frame buffer (4 bits per pixel, even pixel low)
+
+// flip LED
+void flip_led( void ) {
+    if (state == true) {
+        LEDON;
+    } else {
+        LEDOFF;
+    }
+    state = !state;
+}
+
+// to set a pixel to a shade (0 = black .. 15 = white)
+void sfb_pset( int x, int y, int s ) {
+    if ((x < 0) || (x >= SFB_W) || (y < 0) || (y >= SFB_H)) {
+        return;
+    }
+    uint8_t *p = &sfb[y][x >> 1];
+    *p = (x & 1) ? ((*p & 0x0F) | (s << 4)) : ((*p & 0xF0) | s);
+}
+
+// to fill a rectangle with a shade
+void sfb_fill_rect( int x, int y, int w, int h, int s ) {
+    for (int j = y; j < y + h; j++) {
+        for (int i = x; i < x + w; i++) {
+            sfb_pset(i, j, s);
+        }
+    }
+}
+
+// put a character of the 8x8 font (white on black) at (x, y) in pixels
+void sfb_put_char( int x, int y, unsigned char c ) {
+    if (c >= ASCII_CHAR_NUM) {
+        c = ' ';
+    }
+    for (int i = 0; i < CHAR_H; i++) {
+        unsigned char bits = ascii_table[c][i];
+        for (int j = 0; j < CHAR_W; j++) {
+            sfb_pset(x + j, y + i, ((bits >> j) & 1) ? 15 : 0);
+        }
+    }
+}
+
+// put a character of hud (x in characters, y in pixels)
+void sfb_hud_put( int x, int y, unsigned char c ) {
+    sfb_put_char(x * CHAR_W, y, c);
+}
+
+// put strings (x in characters, y in pixels)
+void sfb_strings( int x, int y, const char *mes ) {
+    for (; *mes != '\0'; mes++, x++) {
+        sfb_hud_put(x, y, (unsigned char)*mes);
+    }
+}
+
+// square root of an integer
+int isqrt( int n ) {
+    int r = 0;
+    for (int b = 1 << 14; b > 0; b >>= 1) {
+        if ((r + b) * (r + b) <= n) {
+            r += b;
+        }
+    }
+    return r;
+}
+
+// draw the ball lit from the upper left (normals and light in Q8)
+void draw_ball( void ) {
+    const int lx = -128, ly = -128, lz = 181;
+    for (int dy = -BALL_R; dy <= BALL_R; dy++) {
+        for (int dx = -BALL_R; dx <= BALL_R; dx++) {
+            int nx = dx * 256 / BALL_R, ny = dy * 256 / BALL_R;
+            int n2 = nx * nx + ny * ny;
+            if (n2 > 65536) {
+                continue;
+            }
+            int nz = isqrt(65536 - n2);
+            int dot = (nx * lx + ny * ly + nz * lz) >> 8;
+            int s = 1 + ((dot > 0) ? dot * 14 / 256 : 0);
+            sfb_pset(BALL_X + dx, BALL_Y + dy, s);
+        }
+    }
+}
+
+// draw the gradient band moved by a pixel
+void move_ramp( void ) {
+    ramp_phase++;
+    for (int y = RAMP_Y; y < RAMP_Y + RAMP_H; y++) {
+        for (int x = 0; x < SFB_W; x++) {
+            int s = ((x + ramp_phase) >> 3) & 31;
+            sfb_pset(x, y, (s < 16) ? s : 31 - s);
+        }
+    }
+}
+
+// to generate horizontal sync siganl
+void __not_in_flash_func(hsync)( void ) {
+    SYNC;
+    video_wait_cycles(video_sync_cycles);
+    BLACK;
+    video_wait_cycles(video_porch_cycles);
+}
+
+// to generate vertical sync siganl
+void __not_in_flash_func(vsync)( void ) {
+    // two broad pulses of half a line, a serration of hsync width between
+    SYNC;
+    video_wait_cycles(video_broad_cycles);
+    BLACK;
+    video_wait_cycles(video_sync_cycles);
+
+    SYNC;
+    video_wait_cycles(video_broad_cycles);
+    BLACK;
+    // the second serration lasts until the next line interrupt
+}
+
+// handler for holizontal line processing
+void __not_in_flash_func(horizontal_line)( ) {
+    // Clear the interrupt flag that brought us here
+    pwm_clear_irq(pwm_gpio_to_slice_num(GPPWM));
+
+    // vertical synchronization duration
+    if (count >= video_now->vsync_first && count <= video_now->vsync_last) {
+        vsync();    // vertical SYNC
+
+    // frame buffer drawing area
+    } else if (count >= V_BASE && count < V_BASE + SFB_H) {
+        hsync();
+        int y = count - V_BASE;
+        // dithered codes of two pixels per byte, pattern of this line and frame
+        const uint8_t *lut = dither_lut[DITHER_PHASE(y, frame)];
+        const uint8_t *line = sfb[y];
+        for (int i = 0; i < SFB_W / 2; i++) {
+            uint32_t pix = lut[line[i]];
+            LEVEL(pix & DAC_CODE_MASK);
+            LEVEL(pix >> DAC_BITS);
+        }
+        BLACK;
+    } else {
+        hsync();
+        BLACK;
+    }
+    // count up scan line
+    count++;
+    // if scan line reach to max
+    if (count > video_now->lines) {
+        count = 1;
+        frame++;
+    }
+    return;
+}
+
+int main() {
+
+    // initialize the GPIOs of the ladder for masked output
+    gpio_init_mask(DAC_MASK);
+    gpio_set_dir_out_masked(DAC_MASK);
+    // initialize LED GPIO
+    gpio_init(LED);
+    gpio_init_mask(MLED);
+    gpio_set_dir(LED, GPIO_OUT);
+    // select NTSC, PAL or PAL-M by the strap pins (and set the system clock
+    // before the peripherals take their dividers from it)
+    video_timing_init();
+    // init stdio
+    stdio_init_all();
+    // levels of the ladder and dither table
+    dither_init();
+
+    // GPPWM pin is the PWM output
+    gpio_set_function(GPPWM, GPIO_FUNC_PWM);
+    // Figure out which slice we just connected to the GPPWM pin
+    uint slice_num = pwm_gpio_to_slice_num(GPPWM);
+
+    // Mask our slice's IRQ output into the PWM block's single interrupt line,
+    // and register our interrupt handler
+    pwm_clear_irq(slice_num);
+    pwm_set_irq_enabled(slice_num, true);
+    irq_set_priority(PWM_IRQ_WRAP, 0xC0);
+    irq_set_exclusive_handler(PWM_IRQ_WRAP, horizontal_line);
+    irq_set_enabled(PWM_IRQ_WRAP, true);
+
+    // Set counter wrap value to generate PWM interrupt by this value
+    pwm_set_wrap(slice_num, video_pwm_wrap());
+    // Load the configuration into our PWM slice, and set it running.
+    pwm_set_enabled(slice_num, true);
+
+    // "DITHER  LEVELS 3" and the voltage of each level
+    sfb_strings(0, 0, "DITHER  LEVELS");
+    hud_number(15, 0, 1, 0, dac_levels, sfb_hud_put);
+    sfb_strings(28, MV_Y, "mV");
+    for (int i = 0; i < dac_levels; i++) {
+        hud_number(i * 4, MV_Y, 4, 0, dac_mv[dac_level[i]], sfb_hud_put);
+    }
+    // bars of the 16 shades with their numbers
+    for (int s = 0; s < DITHER_SHADES; s++) {
+        sfb_fill_rect(s * 16, BAR_Y, 16, BAR_H, s);
+        sfb_put_char(s * 16 + 4, BAR_Y + BAR_H + 2, "0123456789ABCDEF"[s]);
+    }
+    draw_ball();
+
+    volatile int countup = 0;
+    while (1) {
+        if (countup % 200000 == 0) {
+            // flip LED
+            flip_led();
+        }
+        if (countup % 20000 == 0) {
+            move_ramp();
+        }
+        countup++;
+        // count a tick of the host benchmark
+        BENCH_TICK();
+    }
+
+    return 0;
+}
@@ -5,14 +5,15 @@
 
 #include <stdio.h>
 #include <string.h>
-#include <math.h>
 #include "pico/stdlib.h"
 #include "hardware/irq.h"
 #include "hardware/pwm.h"
+#include "video_timing.h"     // NTSC, PAL and PAL-M
 #include "hardware/adc.h"
 #include "font8x8_basic.h"
 
-#define CONV_FACTOR (3.3f / (1 << 12)) // ADC data -> voltage (white Pico)
+#define CONV_MVOLT  3300    // ADC data * CONV_MVOLT >> 12 -> voltage in mV (white Pico)
+#define TEMP_SLOPE  5950    // 1024 * 10 / 1.721 (0.1 degree per mV, Q10)
 #define ADC_TEMP    4 // temperature sensor input
 #define LED     25      // GPIO connected LED on the board
 #define MLED    (1 << LED)
@@ -27,20 +28,28 @@
 #define WHITE   gpio_put_masked((M14 | M15), (M14 | M15))   // GPIO14='H' and GPIO15='H'
 #define BLACK   gpio_put_masked((M14 | M15), M15)           // GPIO14='L' and GPIO15='H'
 #define GRAY    gpio_put_masked((M14 | M15), M14)           // GPIO14='H' and GPIO15='L'
+#define LEVEL(v)    gpio_put_masked((M14 | M15), (v) << GP14)   // 2-bit level code (GPIO15:GPIO14)
 #define VRAM_W  32      // width size of VRAM
 #define VRAM_H  24      // height size of VRAM
 //#define CHAR_W  8       // width of a character
 //#define CHAR_H  8       // height of a character
 #define GVRAM_W (VRAM_W * CHAR_W)   // width size of graphic VRAM
 #define GVRAM_H (VRAM_H * CHAR_H)   // height size of graphic VRAM
-#define V_BASE  48      // horizontal line number to start displaying VRAM
-#define BDOT    0       // black dot
-#define WDOT    1       // white dot
-#define GDOT    2       // gray dot
+#define V_BASE  (48 + video_v_shift)  // horizontal line number to start displaying VRAM (NTSC)
+#define BDOT    GV_BLACK    // black dot
+#define WDOT    GV_WHITE    // white dot
+#define GDOT    GV_GRAY     // gray dot
 #define BAR_MAX 20      // bar length
-#define PI      3.14159265
+#define ROT_X   212     // centre of rotating shape
+#define ROT_Y   156
+#define ROT_R   28      // radius of rotating shape
+#define ROT_N   5       // vertices of rotating shape
+
+#include "gvram.h"       // packed graphic VRAM (needs GVRAM_W and GVRAM_H)
+#include "gfont.h"       // fonts for graphic mode
+#include "gfx.h"         // lines, circles and fixed-point sin/cos
+#include "hud.h"         // numbers without printf
 
-volatile unsigned char vram[GVRAM_W][GVRAM_H]; // VRAM
 int count = 1;                      // horizontal line counter
 int count_vsync = 0;
 int bx = 0; int by = 0;
@@ -49,59 +58,10 @@ int buf_len = 1;
 volatile bool state = true;
 int bar_len = 0;
 bool bar_inc = true;
-
-// to clear VRAM contents (set to 0)
-void vram_clear( void ) {
-    for (int i = 0; i < GVRAM_W; i++) {
-        for (int j = 0; j < GVRAM_H; j++) {
-            vram[i][j] = 0;
-        }
-    }
-}
-
-// to write a value into VRAM located at (x, y)
-void vram_write ( int x, int y, unsigned char value ) {
-    vram[x][y] = value;
-}
-
-// to read a value from VRAM located at (x, y)
-unsigned char vram_read( int x, int y) {
-    return vram[x][y];
-}
-
-// put a character on VRAM
-void vram_put_char( int x, int y, char c, char col ) {
-    unsigned char cp;
-    for (int i = 0; i < CHAR_H; i++) {
-        cp = ascii_table[c][i];
-        for (int j = 0; j < CHAR_W; j++) {
-            if ((cp & (1 << j)) != 0) {
-                vram[x + j][y + i] = col;
-            } else {
-                vram[x + j][y + i] = BDOT;
-            }
-        }
-    }
-}
-
-// put strings on VRAM
-void vram_strings( int x, int y, char *mes, char col ) {
-    // if invalid (x, y), return
-    if ((x < 0) || (x > GVRAM_W) || (y < 0) || (y > GVRAM_H)) {
-        return;
-    }
-    int l = strlen(mes);
-    for (int i = 0; i < l * CHAR_W; i += CHAR_W) {
-        // if x position overflows, return
-        if (x + i >= GVRAM_W) {
-            return;
-        // else put a character at the position
-        } else {
-            vram_put_char(x + i, y, mes[i / CHAR_W], col);
-        }
-    }
-    return;
-}
+gfont font_6x8p;                    // proportional 6x8 font
+unsigned char font_6x8p_width[FONT6X8_NUM];
+int rot_angle = 0;                  // angle of rotating shape
+int rot_x[ROT_N], rot_y[ROT_N];     // vertices drawn last
 
 // flip LED
 void flip_led( void ) {
@@ -113,33 +73,50 @@ void flip_led( void ) {
     state = !state;
 }
 
-// measure Temperature and display
-void measure_temp( int x, int y, int col ) {
+// put a character of measure_temp() (x in characters, y in pixels)
+void temp_put( int x, int y, unsigned char c ) {
+    gfont_put_char(x * CHAR_W, y, &font_8x8, c, WDOT, BDOT);
+}
+
+// measure Temperature and display (x in characters, y in pixels)
+void measure_temp( int x, int y ) {
     uint16_t temp_dat;
-    float voltage, temp;
-    char mes[VRAM_W];
+    int mvolt, temp10;
     // read ADC(temperature) data
     temp_dat = adc_read();
-    // convert ADC data to voltage
-    voltage = temp_dat * CONV_FACTOR;
-    // convert voltage to temperature
-    temp = 27 - (voltage - 0.706) / 0.001721;
-    // make massage from voltage and temp
-    sprintf(mes, "V=%2.3f T=%2.1f", voltage, temp);
-    // display voltage and temp
-    vram_strings(x, y, mes, col);
+    // convert ADC data to voltage (mV)
+    mvolt = (temp_dat * CONV_MVOLT) >> 12;
+    // convert voltage to temperature (0.1 degree)
+    temp10 = 270 - (((mvolt - 706) * TEMP_SLOPE) >> 10);
+    // display voltage and temp as "V=0.706 T= 27.0"
+    gfont_strings(x * CHAR_W, y, &font_8x8, "V=      T=", WDOT, BDOT);
+    hud_number(x + 2, y, 5, 3, mvolt, temp_put);
+    hud_number(x + 10, y, 5, 1, temp10, temp_put);
+}
+
+// rotate the shape: erase the previous one and draw at the next angle
+void rotate_shape( void ) {
+    gfx_polygon(rot_x, rot_y, ROT_N, BDOT);
+    gfx_circle(ROT_X, ROT_Y, ROT_R, GDOT);
+    rot_angle += 8;
+    for (int i = 0; i < ROT_N; i++) {
+        int a = rot_angle + i * 2 * GFX_ANGLES / ROT_N;     // star: every second vertex
+        rot_x[i] = ROT_X + GFX_MUL(gfx_cos(a), ROT_R);
+        rot_y[i] = ROT_Y + GFX_MUL(gfx_sin(a), ROT_R);
+    }
+    gfx_polygon(rot_x, rot_y, ROT_N, WDOT);
 }
 
 // display bar at the line with given character
 void display_bar( int x, int y, char c, char col ) {
     if (bar_inc == true) {
-        vram_put_char(x + bar_len * CHAR_W, y, c, col);
+        gfont_put_char(x + bar_len * CHAR_W, y, &font_8x8, c, col, BDOT);
         bar_len++;
         if (bar_len == BAR_MAX) {
             bar_inc = false;
         }
     } else {
-        vram_put_char(x + bar_len * CHAR_W, y, ' ', col);
+        gfont_put_char(x + bar_len * CHAR_W, y, &font_8x8, ' ', col, BDOT);
         bar_len--;
         if (bar_len == 0) {
             bar_inc = true;
@@ -148,39 +125,36 @@ void display_bar( int x, int y, char c, char col ) {
 }
 
 // to generate horizontal sync siganl
-void hsync( void ) {
+void __not_in_flash_func(hsync)( void ) {
     SYNC;
-    sleep_us(5);
+    video_wait_cycles(video_sync_cycles);
     BLACK;
-    sleep_us(7);
+    video_wait_cycles(video_porch_cycles);
 }
 
 // to generate vertical sync siganl
-void vsync ( void ) {
+void __not_in_flash_func(vsync)( void ) {
+    // two broad pulses of half a line, a serration of hsync width between
     SYNC;
-    sleep_us(10);
-    sleep_us(5);
-    sleep_us(10);
+    video_wait_cycles(video_broad_cycles);
     BLACK;
-    sleep_us(5);
+    video_wait_cycles(video_sync_cycles);
 
     SYNC;
-    sleep_us(10);
-    sleep_us(5);
-    sleep_us(10);
+    video_wait_cycles(video_broad_cycles);
     BLACK;
-    sleep_us(5);
+    // the second serration lasts until the next line interrupt
 
     count_vsync++;
 }
 
 // handler for holizontal line processing
-void horizontal_line( ) {
+void __not_in_flash_func(horizontal_line)( ) {
     // Clear the interrupt flag that brought us here
     pwm_clear_irq(pwm_gpio_to_slice_num(GPPWM));
 
     // vertical synchronization duration
-    if (count >= 3 && count <= 5) {
+    if (count >= video_now->vsync_first && count <= video_now->vsync_last) {
         vsync();    // vertical SYNC
 
     // VRAM drawing area
@@ -188,30 +162,23 @@ void horizontal_line( ) {
         hsync();
         // left blank??
         BLACK;
-        sleep_us(0);    // should be tuned
+        video_wait_us(0);    // should be tuned
 
         int y = count - V_BASE;
-        for (int x = 0; x < GVRAM_W; x++) {
-            int c = vram[x][y];
-            switch (c) {
-                case BDOT:  // black
-                BLACK;
-                break;
-                case WDOT:  // white
-                WHITE;
-                break;
-                case GDOT:  // gray
-                GRAY;
-                break;
-                default:
-                BLACK;
+        // packed pixels of this line (16 level codes per word)
+        uint32_t *line = gvram[y];
+        for (int i = 0; i < GVRAM_WORDS; i++) {
+            uint32_t pix = line[i];
+            for (int w = 0; w < GV_PPW; w++) {
+                LEVEL(pix & 3);
+                pix >>= 2;
             }
         }
 
 /*
         WHITE;
-        sleep_us(10);
-        sleep_us(10);
+        video_wait_us(10);
+        video_wait_us(10);
 */
         // right blank??
         BLACK;
@@ -222,7 +189,7 @@ void horizontal_line( ) {
     // count up scan line 
     count++;
     // if scan line reach to max
-    if (count > 262) {
+    if (count > video_now->lines) {
         count = 1;
     }
     return;
@@ -240,6 +207,9 @@ int main() {
     gpio_init(LED);
     gpio_init_mask(MLED);
     gpio_set_dir(LED, GPIO_OUT);
+    // select NTSC, PAL or PAL-M by the strap pins (and set the system clock
+    // before the peripherals take their dividers from it)
+    video_timing_init();
     // init stdio
     stdio_init_all();
     // init ADC
@@ -249,7 +219,9 @@ int main() {
     // select ADC input
     adc_select_input(ADC_TEMP);    // ADC selected
     // clear VRAM
-    vram_clear();
+    gvram_init();
+    // make proportional 6x8 font
+    gfont_proportional(&font_6x8p, &font_6x8, font_6x8p_width);
 
     // GPPWM pin is the PWM output
     gpio_set_function(GPPWM, GPIO_FUNC_PWM);
@@ -268,21 +240,39 @@ int main() {
     // counter is allowed to wrap over its maximum range (0 to 2**16-1)
     pwm_config config = pwm_get_default_config();
     // Set counter wrap value to generate PWM interrupt by this value
-    pwm_set_wrap(slice_num, 7999);
+    pwm_set_wrap(slice_num, video_pwm_wrap());
     // Load the configuration into our PWM slice, and set it running.
     pwm_set_enabled(slice_num, true);
 
     volatile int countup;
-    double y0, y1;
+    int y0, y1, py0, py1;
 
+    // connect the points of the curves by lines
     for (int x = 0; x < GVRAM_W; x++) {
-        y0 = sin(2.0 * PI / GVRAM_W * (double)x) * (GVRAM_H / 2) + GVRAM_H / 2;
-        y1 = cos(2.0 * PI / GVRAM_W * (double)x) * (GVRAM_H / 2) + GVRAM_H / 2;
-        vram_write(x, y0, 1);
-        vram_write(x, y1, 2);
+        int a = x * GFX_ANGLES / GVRAM_W;
+        y0 = GVRAM_H / 2 + GFX_MUL(gfx_sin(a), GVRAM_H / 2 - 1);
+        y1 = GVRAM_H / 2 + GFX_MUL(gfx_cos(a), GVRAM_H / 2 - 1);
+        if (x == 0) {
+            py0 = y0; py1 = y1;
+        }
+        gfx_line(x - 1, py0, x, y0, WDOT);
+        gfx_line(x - 1, py1, x, y1, GDOT);
+        py0 = y0; py1 = y1;
+    }
+    gfont_strings(10, 10, &font_8x8, "SIN curve", WDOT, BDOT);
+    gfont_strings(10, 20, &font_8x8, "COS curve", GDOT, BDOT);
+    // other font sizes
+    gfont_strings(10, 70, &font_8x16, "NTSC", WDOT, GV_NONE);
+    gfont_strings(10, 90, &font_6x8, "6x8 fixed:  SCORE 012345 HP 3", WDOT, BDOT);
+    gfont_strings(10, 100, &font_6x8p, "6x8 proportional: Hi-Score 012345", WDOT, BDOT);
+    gfont_strings(10, 112, &font_4x6, "4x6: OXYGEN 100 FLOOR 150 STAGE 1 TEMP 27.0", GDOT, BDOT);
+    gfont_strings(10, 120, &font_4x6, "abcdefghijklmnopqrstuvwxyz 0123456789", WDOT, BDOT);
+    // window of the rotating shape
+    gfx_fill_rect(ROT_X - ROT_R - 4, ROT_Y - ROT_R - 4, ROT_R * 2 + 9, ROT_R * 2 + 9, BDOT);
+    gfx_rect(ROT_X - ROT_R - 4, ROT_Y - ROT_R - 4, ROT_R * 2 + 9, ROT_R * 2 + 9, GDOT);
+    for (int i = 0; i < ROT_N; i++) {
+        rot_x[i] = ROT_X; rot_y[i] = ROT_Y;
     }
-    vram_strings(10, 10, "SIN curve", WDOT);
-    vram_strings(10, 20, "COS curve", GDOT);
 
     while (1) {
         if (countup % 200000 == 0) {
@@ -290,11 +280,14 @@ int main() {
             flip_led();
         }
         if (countup % 300000 == 0) {
-            measure_temp(10, 30, WDOT);
+            measure_temp(1, 30);
         }
         if (countup % 10000 == 0) {
             display_bar(0, 50, '#', GDOT);
         }
+        if (countup % 5000 == 0) {
+            rotate_shape();
+        }
 
         countup++;
     }
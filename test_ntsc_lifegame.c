@@ -10,11 +10,17 @@
 #include "pico/stdlib.h"
 #include "hardware/irq.h"
 #include "hardware/pwm.h"
+#include "video_timing.h"     // NTSC, PAL and PAL-M
 #include "hardware/adc.h"
 #include "font8x8_basic.h"
+#include "font8x8_2bpp.h"     // generated by tools/fontgen
+#include "bench.h"
+#include "hud.h"
+#include "vdma.h"             // VRAM clear by DMA
 //#include "font7x5_basic.h"
 
-#define CONV_FACTOR (3.3f / (1 << 12)) // ADC data -> voltage (white Pico)
+#define CONV_MVOLT  3300    // ADC data * CONV_MVOLT >> 12 -> voltage in mV (white Pico)
+#define TEMP_SLOPE  5950    // 1024 * 10 / 1.721 (0.1 degree per mV, Q10)
 #define ADC_TEMP    4 // temperature sensor input
 #define LED     25      // GPIO connected LED on the board
 #define MLED    (1 << LED)
@@ -29,9 +35,10 @@
 #define WHITE   gpio_put_masked(M14 | M15, M14 | M15)     // GPIO14='H' and GPIO15='H'
 #define BLACK   gpio_put_masked(M14 | M15, M15)           // GPIO14='L' and GPIO15='H'
 #define GRAY    gpio_put_masked(M14 | M15, M14)           // GPIO14='H' and GPIO15='L'
+#define LEVEL(v)    gpio_put_masked(M14 | M15, (v) << GP14)   // 2-bit level code (GPIO15:GPIO14)
 #define VRAM_W  30      // width size of VRAM
 #define VRAM_H  28      // height size of VRAM
-#define V_BASE  24      // horizontal line number to start displaying VRAM
+#define V_BASE  (24 + video_v_shift)  // horizontal line number to start displaying VRAM (NTSC)
 #define BAR_MAX (VRAM_W-1)      // bar length
 
 #define LIFE_SIZE   25  // size of life field
@@ -43,7 +50,7 @@
 #define WBOX    0       // character for dead life (5)
 #define STABLE  30      // stages for judging stable state
 
-volatile unsigned char vram[VRAM_W][VRAM_H]; // VRAM
+volatile unsigned char vram[VRAM_H][VRAM_W]; // VRAM (row-major)
 volatile int count = 1;                      // horizontal line counter
 int count_vsync = 0;
 int bx = 0; int by = 0;
@@ -53,23 +60,20 @@ volatile bool state = true;
 
 int life[LIFE_SIZE][LIFE_SIZE];
 
-// to clear VRAM contents (set to 0)
+// to clear VRAM contents (set to 0) by DMA
 void vram_clear( void ) {
-    for (int i = 0; i < VRAM_W; i++) {
-        for (int j = 0; j < VRAM_H; j++) {
-            vram[i][j] = 0;
-        }
-    }
+    vdma_fill(vram, 0, sizeof(vram));
+    vdma_wait();
 }
 
 // to write a value into VRAM located at (x, y)
 void vram_write ( int x, int y, unsigned char value ) {
-    vram[x][y] = value;
+    vram[y][x] = value;
 }
 
 // to read a value from VRAM located at (x, y)
 unsigned char vram_read( int x, int y) {
-    return vram[x][y];
+    return vram[y][x];
 }
 
 // to write strings into VRAM located at (x, y)
@@ -85,7 +89,7 @@ void vram_strings( int x, int y, char *mes) {
             return;
         // else put a character at the position
         } else {
-            vram[x + i][y] = mes[i];
+            vram[y][x + i] = mes[i];
         }
     }
     return;
@@ -104,18 +108,17 @@ void flip_led( void ) {
 // measure Temperature and display
 void measure_temp( int line ) {
     uint16_t temp_dat;
-    float voltage, temp;
-    char mes[VRAM_W];
+    int mvolt, temp10;
     // read ADC(temperature) data
     temp_dat = adc_read();
-    // convert ADC data to voltage
-    voltage = temp_dat * CONV_FACTOR;
-    // convert voltage to temperature
-    temp = 27 - (voltage - 0.706) / 0.001721;
-    // make massage from voltage and temp
-    sprintf(mes, "V=%2.3f T=%2.1f", voltage, temp);
-    // display voltage and temp
-    vram_strings(0, line, mes);
+    // convert ADC data to voltage (mV)
+    mvolt = (temp_dat * CONV_MVOLT) >> 12;
+    // convert voltage to temperature (0.1 degree)
+    temp10 = 270 - (((mvolt - 706) * TEMP_SLOPE) >> 10);
+    // display voltage and temp as "V=0.706 T= 27.0"
+    vram_strings(0, line, "V=      T=");
+    hud_number(2, line, 5, 3, mvolt, vram_write);
+    hud_number(10, line, 5, 1, temp10, vram_write);
 }
 
 // initialize random seed by ADC data
@@ -137,6 +140,9 @@ void gen_life( ) {
     }
 }
 
+// judge life if dead or alive (defined below)
+int dead_or_alive(int x, int y);
+
 // update life map
 void update_life( ) {
     int tmp_life[LIFE_SIZE][LIFE_SIZE];
@@ -224,39 +230,36 @@ void draw_life( ) {
 }
 
 // to generate horizontal sync siganl
-void hsync( void ) {
+void __not_in_flash_func(hsync)( void ) {
     SYNC;
-    sleep_us(5);
+    video_wait_cycles(video_sync_cycles);
     BLACK;
-    sleep_us(7);
+    video_wait_cycles(video_porch_cycles);
 }
 
 // to generate vertical sync siganl
-void vsync ( void ) {
+void __not_in_flash_func(vsync)( void ) {
+    // two broad pulses of half a line, a serration of hsync width between
     SYNC;
-    sleep_us(10);
-    sleep_us(5);
-    sleep_us(10);
+    video_wait_cycles(video_broad_cycles);
     BLACK;
-    sleep_us(5);
+    video_wait_cycles(video_sync_cycles);
 
     SYNC;
-    sleep_us(10);
-    sleep_us(5);
-    sleep_us(10);
+    video_wait_cycles(video_broad_cycles);
     BLACK;
-    sleep_us(5);
+    // the second serration lasts until the next line interrupt
 
     count_vsync++;
 }
 
 // handler for holizontal line processing
-void horizontal_line( ) {
+void __not_in_flash_func(horizontal_line)( ) {
     // Clear the interrupt flag that brought us here
     pwm_clear_irq(pwm_gpio_to_slice_num(GPPWM));
 
     // vertical synchronization duration
-    if (count >= 3 && count <= 5) {
+    if (count >= video_now->vsync_first && count <= video_now->vsync_last) {
         vsync();    // vertical SYNC
 
     // VRAM drawing area
@@ -264,28 +267,28 @@ void horizontal_line( ) {
         hsync();
         // left blank??
         BLACK;
-        sleep_us(0);    // should be tuned
+        video_wait_us(0);    // should be tuned
 
         // calculate VRAM y position from scan line number
         int y = (count - V_BASE) / CHAR_H;
-        int cline = count % CHAR_H;
+        int cline = (count - V_BASE) % CHAR_H;
+        // pixel levels of all characters for this line
+        const uint16_t *row = font8x8_2bpp[cline];
+        // characters of this text row (contiguous)
+        const volatile unsigned char *text = vram[y];
         // horizontal VRAM drawing
         for (int x = 0; x < VRAM_W; x++) {
-            // read VRAM
-            volatile unsigned char c = vram[x][y];
-            // draw bit from character table (ascii_table)
+            // read VRAM and the pixel levels of the character (2 bits per pixel)
+            uint32_t pix = row[text[x]];
+            // draw pixels from the levels
             for (int w = 0; w < CHAR_W; w++) {
-                if ((ascii_table[c][cline] & (1 << w)) != 0) {
-                    WHITE;
-                } else {
-                    volatile uint16_t tmp = 1;
-                    BLACK;
-                }
+                LEVEL(pix & 3);
+                pix >>= 2;
             }
         }
         // right blank??
         BLACK;
-        sleep_us(0);
+        video_wait_us(0);
     } else {
         hsync();
         BLACK;
@@ -293,7 +296,7 @@ void horizontal_line( ) {
     // count up scan line 
     count++;
     // if scan line reach to max
-    if (count > 262) {
+    if (count > video_now->lines) {
         count = 1;
     }
     return;
@@ -311,6 +314,9 @@ int main() {
     gpio_init(LED);
     gpio_init_mask(MLED);
     gpio_set_dir(LED, GPIO_OUT);
+    // select NTSC, PAL or PAL-M by the strap pins (and set the system clock
+    // before the peripherals take their dividers from it)
+    video_timing_init();
     // init stdio
     stdio_init_all();
     // init ADC
@@ -319,6 +325,8 @@ int main() {
     adc_set_temp_sensor_enabled(true);
     // select ADC input
     adc_select_input(ADC_TEMP);    // ADC selected
+    // claim the DMA channel of VRAM operations
+    vdma_init(true);
     // clear VRAM
     vram_clear();
     // initialize random seed
@@ -338,7 +346,7 @@ int main() {
     irq_set_enabled(PWM_IRQ_WRAP, true); 
 
     // Set counter wrap value to generate PWM interrupt by this value
-    pwm_set_wrap(slice_num, 7999);
+    pwm_set_wrap(slice_num, video_pwm_wrap());
     // Load the configuration into our PWM slice, and set it running.
     pwm_set_enabled(slice_num, true);
 
@@ -347,9 +355,13 @@ int main() {
 
     int countup = 0;
     int stages = 0;
-    int num_live, num_live_p;
+    int num_live, num_live_p = 0;
     int stable_count = 0;
-    char mes[VRAM_W];
+    hud_field hud_stage, hud_lives;
+    vram_strings(5, 1, "Stage =");
+    vram_strings(5, 2, "Lives =");
+    hud_init(&hud_stage, 13, 1, 5, vram_write);
+    hud_init(&hud_lives, 13, 2, 5, vram_write);
 
     while (1) {
         if (countup % 200000 == 0) {
@@ -358,18 +370,20 @@ int main() {
         }
         if (countup % 200000 == 0) {
             // draw life map
+            BENCH_BEGIN("draw_life");
             draw_life();
+            BENCH_END("draw_life");
             // update life map
+            BENCH_BEGIN("update_life");
             update_life();
+            BENCH_END("update_life");
             // count lives
+            BENCH_BEGIN("count_life");
             num_live = count_life();
+            BENCH_END("count_life");
             // display messages
-            vram_strings(0, 1, "                  ");
-            vram_strings(0, 2, "                  ");
-            sprintf(mes, "Stage = %d", stages++);
-            vram_strings(5, 1, mes);
-            sprintf(mes, "Lives = %d", count_life());
-            vram_strings(5, 2, mes);
+            hud_set(&hud_stage, stages++);
+            hud_set(&hud_lives, num_live);
             // if number of lives is equal to the previous number
             if (num_live == num_live_p) {
                 // count up stable state
@@ -389,6 +403,8 @@ int main() {
             num_live_p = num_live;
         }
 
+        // count a tick of the host benchmark
+        BENCH_TICK();
         countup++;
     }
 
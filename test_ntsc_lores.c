@@ -0,0 +1,147 @@
+/**
+ * Test program for NTSC signal generation.
+ * Low-resolution graphic mode of the PIO video engine (ntsc_video.h):
+ * 128 x 96 pixels doubled both ways fill the screen from a 3KB packed
+ * graphic VRAM, redrawn in full every frame (a rotating star and bouncing
+ * balls).  The VRAM is cleared by DMA (vdma.h) while the balls move.
+ * Define LORES_H as 192 for 128 x 192 (pixels doubled across).
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "ntsc_video.h"
+#define BENCH_TICKS 600 // frames of the host benchmark
+#include "bench.h"
+
+#define LED     25      // GPIO connected LED on the board
+#define MLED    (1 << LED)
+#define LEDON   gpio_put_masked(MLED, MLED)
+#define LEDOFF  gpio_put_masked(MLED, 0)
+#define LORES_H 96      // lines of the graphic VRAM: 96 or 192
+#define GVRAM_W 128     // width size of graphic VRAM
+#define GVRAM_H LORES_H // height size of graphic VRAM
+#define ROT_X   (GVRAM_W / 2)   // centre of rotating shape
+#define ROT_Y   (GVRAM_H / 2)
+#define ROT_R   (GVRAM_H / 3)   // radius of rotating shape
+#define ROT_N   5       // vertices of rotating shape
+#define NBALL   4       // bouncing balls
+#define BALL_R  4
+
+#include "gvram.h"       // packed graphic VRAM (needs GVRAM_W and GVRAM_H)
+#include "gfont.h"       // fonts for graphic mode
+#include "gfx.h"         // lines, circles and fixed-point sin/cos
+#include "hud.h"         // numbers without printf
+#include "vdma.h"        // VRAM clear by DMA
+
+volatile bool state = true;
+
+typedef struct {
+    int x, y;           // centre
+    int dx, dy;         // speed
+    int col;
+} ball;
+
+ball balls[NBALL];
+
+// flip LED
+void flip_led( void ) {
+    if (state == true) {
+        LEDON;
+    } else {
+        LEDOFF;
+    }
+    state = !state;
+}
+
+// put a character of the 4x6 font (x in characters, y in pixels)
+void lores_put( int x, int y, unsigned char c ) {
+    gfont_put_char(x * FONT4X6_W, y, &font_4x6, c, GV_WHITE, GV_BLACK);
+}
+
+// draw the star rotated by angle
+void draw_star( int angle ) {
+    int x[ROT_N], y[ROT_N];
+    for (int i = 0; i < ROT_N; i++) {
+        int a = angle + i * 2 * GFX_ANGLES / ROT_N;     // star: every second vertex
+        x[i] = ROT_X + GFX_MUL(gfx_cos(a), ROT_R);
+        y[i] = ROT_Y + GFX_MUL(gfx_sin(a), ROT_R);
+    }
+    gfx_circle(ROT_X, ROT_Y, ROT_R, GV_GRAY);
+    gfx_polygon(x, y, ROT_N, GV_WHITE);
+}
+
+// move the balls
+void move_balls( void ) {
+    for (int i = 0; i < NBALL; i++) {
+        ball *b = &balls[i];
+        b->x += b->dx;
+        b->y += b->dy;
+        if (b->x <= BALL_R || b->x >= GVRAM_W - 1 - BALL_R) {
+            b->dx = -b->dx;
+        }
+        if (b->y <= BALL_R + FONT4X6_H || b->y >= GVRAM_H - 1 - BALL_R) {
+            b->dy = -b->dy;
+        }
+    }
+}
+
+// draw the balls
+void draw_balls( void ) {
+    for (int i = 0; i < NBALL; i++) {
+        gfx_fill_circle(balls[i].x, balls[i].y, BALL_R, balls[i].col);
+    }
+}
+
+int main() {
+    // select NTSC, PAL or PAL-M by the strap pins (and set the system clock
+    // before the peripherals take their dividers from it)
+    video_timing_init();
+    // init stdio
+    stdio_init_all();
+    // initialize LED GPIO
+    gpio_init(LED);
+    gpio_init_mask(MLED);
+    gpio_set_dir(LED, GPIO_OUT);
+    // clear VRAM
+    gvram_init();
+    // claim the DMA channel of VRAM operations, paced to leave the bus to the video
+    vdma_init(true);
+
+    // show the graphic VRAM
+    ntsc_gvram = gvram[0];
+    ntsc_video_init((GVRAM_H == 96) ? &ntsc_graph128x96 : &ntsc_graph128x192);
+
+    for (int i = 0; i < NBALL; i++) {
+        balls[i].x = BALL_R + 1 + i * 29;
+        balls[i].y = GVRAM_H / 2 + i * 5;
+        balls[i].dx = (i & 1) ? 1 : -1;
+        balls[i].dy = (i & 2) ? 1 : -1;
+        balls[i].col = (i & 1) ? GV_GRAY : GV_WHITE;
+    }
+
+    int angle = 0;
+    while (1) {
+        // redraw the whole screen once per frame
+        ntsc_wait_vblank();
+        BENCH_BEGIN("redraw");
+        // clear in the background while the balls move
+        vdma_fill32(gvram[0], GV_FILL(GV_BLACK), GVRAM_H * GVRAM_WORDS);
+        move_balls();
+        vdma_wait();
+        draw_star(angle);
+        draw_balls();
+        gfont_strings(0, 0, &font_4x6, ntsc_mode_now->name, GV_WHITE, GV_BLACK);
+        hud_number(GVRAM_W / FONT4X6_W - 8, 0, 8, 0, ntsc_frame, lores_put);
+        BENCH_END("redraw");
+        angle += 4;
+        if (ntsc_frame % 60 == 0) {
+            // flip LED
+            flip_led();
+        }
+        // count a tick of the host benchmark
+        BENCH_TICK();
+    }
+
+    return 0;
+}
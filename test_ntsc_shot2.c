@@ -10,8 +10,14 @@
 #include "pico/stdlib.h"
 #include "hardware/irq.h"
 #include "hardware/pwm.h"
+#include "video_timing.h"     // NTSC, PAL and PAL-M
 #include "hardware/adc.h"
 #include "font8x8_basic.h"
+#include "font8x8_2bpp.h"     // generated by tools/fontgen
+#include "replay.h"
+#include "bench.h"
+#include "hud.h"
+#include "vdma.h"             // VRAM clear by DMA
 
 #define LED     25      // GPIO connected LED on the board
 #define MLED    (1 << LED)
@@ -26,9 +32,10 @@
 #define WHITE   gpio_put_masked(M14 | M15, M14 | M15)     // GPIO14='H' and GPIO15='H'
 #define BLACK   gpio_put_masked(M14 | M15, M15)           // GPIO14='L' and GPIO15='H'
 #define GRAY    gpio_put_masked(M14 | M15, M14)           // GPIO14='H' and GPIO15='L'
+#define LEVEL(v)    gpio_put_masked(M14 | M15, (v) << GP14)   // 2-bit level code (GPIO15:GPIO14)
 #define VRAM_W  30      // width size of VRAM
 #define VRAM_H  28      // height size of VRAM
-#define V_BASE  24      // horizontal line number to start displaying VRAM
+#define V_BASE  (24 + video_v_shift)  // horizontal line number to start displaying VRAM (NTSC)
 
 #define RKEYGP  11      // Right key GP11
 #define UKEYGP  10      // Up key GP10
@@ -51,7 +58,6 @@
 #define MMRATE  1000    // minimum METEOR rate
 #define IPMETEOR 20      // initial METEOR probability
 #define NHEART  3       // max number of heart
-#define HTRATE  30000   // heart rate
 #define MYRATE  10000   // my rate
 #define BRATE   8000    // beam rate
 #define NBEAM   8       // max number of my shot
@@ -63,8 +69,14 @@
 #define HEART_SCORE     100 // score of heart
 #define LSCORE  1       // line of score drawing
 #define LHP     2       // line of score drawing
-
-volatile unsigned char vram[VRAM_W][VRAM_H]; // VRAM
+#define CME_L   0x10    // codes of me and beam shifted against the scroll (scroll_glyph())
+#define CME_R   0x11
+#define CBEAM_L 0x12
+#define CBEAM_R 0x13
+
+volatile unsigned char vram[VRAM_H][VRAM_W]; // VRAM (row-major)
+#include "scroll.h"     // per-line fine scroll (needs VRAM_H)
+int fine = 0;           // fine scroll of the play field [pixels]
 volatile int count = 1;                      // horizontal line counter
 volatile bool state = true;
 typedef struct {
@@ -75,23 +87,23 @@ typedef struct {
     int sp;         // special power of entity
 } entity;
 
-// to clear VRAM contents (set to 0)
+// column a scrolled entity is nearest to
+#define PLAY_X(e)   ((e).x - (fine >= CHAR_W / 2))
+
+// to clear VRAM contents (set to 0) by DMA
 void vram_clear( void ) {
-    for (int i = 0; i < VRAM_W; i++) {
-        for (int j = 0; j < VRAM_H; j++) {
-            vram[i][j] = 0;
-        }
-    }
+    vdma_fill(vram, 0, sizeof(vram));
+    vdma_wait();
 }
 
 // to write a value into VRAM located at (x, y)
 void vram_write ( int x, int y, unsigned char value ) {
-    vram[x][y] = value;
+    vram[y][x] = value;
 }
 
 // to read a value from VRAM located at (x, y)
 unsigned char vram_read( int x, int y) {
-    return vram[x][y];
+    return vram[y][x];
 }
 
 // to write strings into VRAM located at (x, y)
@@ -107,7 +119,7 @@ void vram_strings( int x, int y, char *mes) {
             return;
         // else put a character at the position
         } else {
-            vram[x + i][y] = mes[i];
+            vram[y][x + i] = mes[i];
         }
     }
     return;
@@ -174,7 +186,8 @@ uint32_t key_scan( ) {
     if (gpio_get(AKEYGP) == 0) result |= AKEY;
     if (gpio_get(BKEYGP) == 0) result |= BKEY;
 
-    return result;
+    // record or replay keys
+    return replay_keys(result);
 }
 
 // initialize METEOR array
@@ -225,15 +238,15 @@ void move_entity( entity *e, int max_num, int threshold ) {
             // move left; if e[i].x < 0, the entity disappears
             e[i].x--;
             // move up/down or stay
-            if ((rand() % 4) == 0) {
-                e[i].y += ((rand() % 2) == 0) ? +1 : -1;
+            if ((replay_rand() % 4) == 0) {
+                e[i].y += ((replay_rand() % 2) == 0) ? +1 : -1;
             }
             if (e[i].y >= VRAM_H) e[i].y = VRAM_H - 1;
             if (e[i].y <= LHP) e[i].y = LHP + 1;
         }
     }
     // generate new entity
-    if (rand() % 100 < threshold) {
+    if (replay_rand() % 100 < threshold) {
         // search disappeared entity position
         for (i = 0; i < max_num; i++) {
             if (e[i].x < 0) break;
@@ -241,8 +254,8 @@ void move_entity( entity *e, int max_num, int threshold ) {
         // if we can generate new entity
         if (i < max_num) {
             e[i].x = VRAM_W - 1;
-            e[i].y = rand() % (VRAM_H - LHP) + LHP + 1;
-            e[i].sp = rand() % POWERUP + 1;
+            e[i].y = replay_rand() % (VRAM_H - LHP) + LHP + 1;
+            e[i].sp = replay_rand() % POWERUP + 1;
         }
     }
     // draw present entity
@@ -254,12 +267,74 @@ void move_entity( entity *e, int max_num, int threshold ) {
     }
 }
 
+// draw entities
+void draw_entity( entity *e, int max_num ) {
+    for (int i = 0; i < max_num; i++) {
+        if (e[i].x >= 0) {
+            vram_write(e[i].x, e[i].y, e[i].c);
+        }
+    }
+}
+
+// draw (or clear) a character as the pair of codes cancelling the fine
+// scroll; the codes go only into free cells and are cleared only where they
+// are, so a meteor or heart sharing a cell with it stays
+void draw_pair( int x, int y, int left, int right, bool draw ) {
+    for (int i = 0; i < 2 && x + i < VRAM_W; i++) {
+        unsigned char code = i ? right : left;
+        unsigned char c = vram_read(x + i, y);
+        bool show = draw && (i == 0 || fine > 0);
+        if (show && (c == ' ' || c == 0)) {
+            vram_write(x + i, y, code);
+        } else if (!show && c == code) {
+            vram_write(x + i, y, ' ');
+        }
+    }
+}
+
+// draw (or clear) me and beams
+void draw_me( entity *me, entity *beam, bool draw ) {
+    for (int i = 0; i < NBEAM; i++) {
+        if (beam[i].hp > 0) {
+            draw_pair(beam[i].x, beam[i].y, CBEAM_L, CBEAM_R, draw);
+        }
+    }
+    draw_pair(me->x, me->y, CME_L, CME_R, draw);
+}
+
+// scroll the play field a pixel left; meteors and hearts move a column
+// every CHAR_W pixels
+void scroll_step( entity *me, entity *beam, entity *meteor, entity *heart, int threshold ) {
+    draw_me(me, beam, false);
+    if (++fine == CHAR_W) {
+        fine = 0;
+        move_entity(meteor, NMETEOR, threshold);
+        move_entity(heart, NHEART, 5);
+    } else {
+        // redraw what was under me and beams
+        draw_entity(meteor, NMETEOR);
+        draw_entity(heart, NHEART);
+    }
+    scroll_rows(LHP + 1, VRAM_H - 1, fine);
+    scroll_glyph(CME_L, CME_R, CME, fine);
+    scroll_glyph(CBEAM_L, CBEAM_R, CBEAM, fine);
+    draw_me(me, beam, true);
+}
+
+// to stop the fine scroll
+void scroll_reset( void ) {
+    fine = 0;
+    scroll_rows(0, VRAM_H - 1, 0);
+    scroll_glyph(CME_L, CME_R, CME, 0);
+    scroll_glyph(CBEAM_L, CBEAM_R, CBEAM, 0);
+}
+
 // scan keys and move me 
 bool move_me( entity *e ) {
     uint32_t keys;
 
     // clear previous me
-    vram_write(e->x, e->y, ' ');
+    draw_pair(e->x, e->y, CME_L, CME_R, false);
     // scan keys
     keys = key_scan();
     // move right
@@ -283,7 +358,7 @@ bool move_me( entity *e ) {
         if (e->y >= VRAM_H) e->y = VRAM_H - 1;
     }
     // draw present me
-    vram_write(e->x, e->y, e->c);
+    draw_pair(e->x, e->y, CME_L, CME_R, true);
 
     return true;
 }
@@ -295,7 +370,7 @@ void shot_beam( entity *e, entity *me ) {
     // clear previous beams
     for (i = 0; i < NBEAM; i++) {
         if (e[i].hp > 0) {
-            vram_write(e[i].x, e[i].y, ' ');
+            draw_pair(e[i].x, e[i].y, CBEAM_L, CBEAM_R, false);
         }
     }
     // move beams
@@ -326,7 +401,7 @@ void shot_beam( entity *e, entity *me ) {
     // draw present beams
     for (i = 0; i < NBEAM; i++) {
         if (e[i].hp > 0) {
-            vram_write(e[i].x, e[i].y, CBEAM);
+            draw_pair(e[i].x, e[i].y, CBEAM_L, CBEAM_R, true);
         }
     }
 }
@@ -338,7 +413,7 @@ int judge_me( entity *me, entity *METEOR, entity *heart) {
     // heart 
     for (i = 0; i < NHEART; i++) {
         // if I've got a heart
-        if ((me->x == heart[i].x) && (me->y == heart[i].y)) {
+        if ((me->x == PLAY_X(heart[i])) && (me->y == heart[i].y)) {
             // calculate bonus score
             bonus = heart[i].sp * HEART_SCORE;
             // clear the heart
@@ -349,7 +424,7 @@ int judge_me( entity *me, entity *METEOR, entity *heart) {
     // METEOR
     for (i = 0; i < NMETEOR; i++) {
         // if I've bumped into METEOR
-        if ((me->x == METEOR[i].x) && (me->y == METEOR[i].y)) {
+        if ((me->x == PLAY_X(METEOR[i])) && (me->y == METEOR[i].y)) {
             // power down my HP
             me->hp--;
             // clear the METEOR
@@ -373,12 +448,13 @@ int judge_beam( entity *meteor, entity *beam ) {
                 // if meteor is alive
                 if (meteor[j].x > 0) {
                     // if beam bump into meteor
-                    if ((beam[i].x == meteor[j].x) && (beam[i].y == meteor[j].y)) {
+                    if ((beam[i].x == PLAY_X(meteor[j])) && (beam[i].y == meteor[j].y)) {
                         // clear the meteor
+                        vram_write(meteor[j].x, meteor[j].y, ' ');
                         meteor[j].x = -1;
                         // clear the beam
                         beam[i].hp = 0;
-                        vram_write(beam[i].x, beam[i].y, ' ');
+                        draw_pair(beam[i].x, beam[i].y, CBEAM_L, CBEAM_R, false);
                         // increment bonus
                         bonus += METEOR_SCORE;
                     }
@@ -396,41 +472,38 @@ void init_random( ) {
         adc_select_input(i);
         seed_val += adc_read();
     }
-    srand(seed_val);
+    replay_srand(seed_val);
 }
 
 // to generate horizontal sync siganl
-void hsync( void ) {
+void __not_in_flash_func(hsync)( void ) {
     SYNC;
-    sleep_us(5);
+    video_wait_cycles(video_sync_cycles);
     BLACK;
-    sleep_us(7);
+    video_wait_cycles(video_porch_cycles);
 }
 
 // to generate vertical sync siganl
-void vsync ( void ) {
+void __not_in_flash_func(vsync)( void ) {
+    // two broad pulses of half a line, a serration of hsync width between
     SYNC;
-    sleep_us(10);
-    sleep_us(5);
-    sleep_us(10);
+    video_wait_cycles(video_broad_cycles);
     BLACK;
-    sleep_us(5);
+    video_wait_cycles(video_sync_cycles);
 
     SYNC;
-    sleep_us(10);
-    sleep_us(5);
-    sleep_us(10);
+    video_wait_cycles(video_broad_cycles);
     BLACK;
-    sleep_us(5);
+    // the second serration lasts until the next line interrupt
 }
 
 // handler for holizontal line processing
-void horizontal_line( ) {
+void __not_in_flash_func(horizontal_line)( ) {
     // Clear the interrupt flag that brought us here
     pwm_clear_irq(pwm_gpio_to_slice_num(GPPWM));
 
     // vertical synchronization duration
-    if (count >= 3 && count <= 5) {
+    if (count >= video_now->vsync_first && count <= video_now->vsync_last) {
         vsync();    // vertical SYNC
 
     // VRAM drawing area
@@ -438,28 +511,39 @@ void horizontal_line( ) {
         hsync();
         // left blank??
         BLACK;
-        sleep_us(0);    // should be tuned
+        video_wait_us(0);    // should be tuned
 
         // calculate VRAM y position from scan line number
         int y = (count - V_BASE) / CHAR_H;
-        int cline = count % CHAR_H;
+        int cline = (count - V_BASE) % CHAR_H;
+        // pixel levels of all characters for this line
+        const uint16_t *row = font8x8_2bpp[cline];
+        // characters of this text row (contiguous)
+        const volatile unsigned char *text = vram[y];
+        // the first character from pixel fine (per-line fine scroll)
+        int fine_x = scroll_x[count - V_BASE];
+        uint32_t pix = row[text[0]] >> (fine_x * 2);
+        for (int w = fine_x; w < CHAR_W; w++) {
+            LEVEL(pix & 3);
+            pix >>= 2;
+        }
         // horizontal VRAM drawing
-        for (int x = 0; x < VRAM_W; x++) {
-            // read VRAM
-            volatile unsigned char c = vram[x][y];
-            // draw bit from character table (ascii_table)
+        for (int x = 1; x < VRAM_W; x++) {
+            // read VRAM and the pixel levels of the character (2 bits per pixel)
+            pix = row[text[x]];
+            // draw pixels from the levels
             for (int w = 0; w < CHAR_W; w++) {
-                if ((ascii_table[c][cline] & (1 << w)) != 0) {
-                    WHITE;
-                } else {
-                    volatile uint16_t tmp = 1;
-                    BLACK;
-                }
+                LEVEL(pix & 3);
+                pix >>= 2;
             }
         }
+        // black for the pixels scrolled in
+        for (int w = 0; w < fine_x; w++) {
+            BLACK;
+        }
         // right blank??
         BLACK;
-        sleep_us(0);
+        video_wait_us(0);
     } else {
         hsync();
         BLACK;
@@ -467,7 +551,7 @@ void horizontal_line( ) {
     // count up scan line 
     count++;
     // if scan line reach to max
-    if (count > 262) {
+    if (count > video_now->lines) {
         count = 1;
     }
     return;
@@ -476,14 +560,23 @@ void horizontal_line( ) {
 int main() {
     // initialize video and LED GPIO
     init_video_and_led_GPIO();
+    // select NTSC, PAL or PAL-M by the strap pins (and set the system clock
+    // before the peripherals take their dividers from it)
+    video_timing_init();
     // init stdio
     stdio_init_all();
     // init ADC
     adc_init();
     // enable temperature sensor
     adc_set_temp_sensor_enabled(true);
+    // claim the DMA channel of VRAM operations
+    vdma_init(true);
     // clear VRAM
     vram_clear();
+    // initialize key GPIO
+    init_key_GPIO();
+    // select record or replay mode by keys held at power on
+    replay_init(key_scan());
     // initialize random seed
     init_random();
 
@@ -501,13 +594,10 @@ int main() {
     irq_set_enabled(PWM_IRQ_WRAP, true); 
 
     // Set counter wrap value to generate PWM interrupt by this value
-    pwm_set_wrap(slice_num, 7999);
+    pwm_set_wrap(slice_num, video_pwm_wrap());
     // Load the configuration into our PWM slice, and set it running.
     pwm_set_enabled(slice_num, true);
 
-    // initialize key GPIO
-    init_key_GPIO();
-
     int countup = 0;
     int score = 0;
     int hi_score = 0;
@@ -516,7 +606,7 @@ int main() {
     uint32_t keys;
     bool blink = true;
     bool initial;
-    char mes[VRAM_W];
+    hud_field hud_score, hud_hi, hud_hp;
     entity me, meteor[NMETEOR], heart[NHEART], beam[NBEAM];
     enum State {IDLE, PLAY, OVER} game_state;
 
@@ -545,37 +635,58 @@ int main() {
                 score = 0;
                 // clear VRAM
                 vram_clear();
+                scroll_reset();
+                // draw HUD labels and fields
+                vram_strings(0, LSCORE, "SCORE       HiSCORE       HP");
+                hud_init(&hud_score, 5, LSCORE, 6, vram_write);
+                hud_init(&hud_hi, 19, LSCORE, 6, vram_write);
+                hud_init(&hud_hp, 28, LSCORE, 2, vram_write);
+                hud_set(&hud_hi, hi_score);
                 // clear initializing flag
                 initial = false;
             }
             // my turn
             if (countup % MYRATE == 0) {
                 // move me
+                BENCH_BEGIN("move_me");
                 move_me(&me);
+                BENCH_END("move_me");
                 // count up score
                 score++;
                 // judge me
+                BENCH_BEGIN("judge_me");
                 score += judge_me(&me, meteor, heart);
+                BENCH_END("judge_me");
                 // if HP is 0
                 if (me.hp <= 0) {
                     // game state is game over
                     game_state = OVER;
+                    scroll_reset();
+                    // save recorded keys for replay and print them
+                    replay_save();
+                    replay_dump();
                 }
                 // display score, hi-score and HP
-                sprintf(mes, "SCORE%6d HiSCORE%6d HP%2d", score, hi_score, me.hp);
-                vram_strings(0, LSCORE, mes);
+                hud_set(&hud_score, score);
+                hud_set(&hud_hp, me.hp);
             }
             // beam turn
             if (countup % BRATE == 0) {
                 // shot beam
+                BENCH_BEGIN("shot_beam");
                 shot_beam(beam, &me);
+                BENCH_END("shot_beam");
                 // judge beam
+                BENCH_BEGIN("judge_beam");
                 score += judge_beam(meteor, beam);
+                BENCH_END("judge_beam");
             }
-            // METEOR turn
-            if (countup % meteor_rate == 0) {
-                // move METEOR
-                move_entity(meteor, NMETEOR, p_meteor);
+            // METEOR turn: a pixel of scroll (a column every CHAR_W)
+            if (countup % (meteor_rate / CHAR_W) == 0) {
+                // move METEOR and heart
+                BENCH_BEGIN("scroll_step");
+                scroll_step(&me, beam, meteor, heart, p_meteor);
+                BENCH_END("scroll_step");
                 // change METEOR rate
                 if (IMRATE - score > MMRATE) {
                     meteor_rate = IMRATE - score;
@@ -586,11 +697,6 @@ int main() {
                 p_meteor = IPMETEOR + score / 200;
                 if (p_meteor >= 99) p_meteor = 99;
             }        
-            // heart turn
-            if (countup % HTRATE == 0) {
-                // move heart
-                move_entity(heart, NHEART, 5);
-            }        
         }
         // idle, waiting for A button
         if (game_state == IDLE) {
@@ -599,11 +705,9 @@ int main() {
                 vram_strings(8,  8, "FLYING METEOR 2!!");
                 vram_strings(8, 10, "    by Pa@ART    ");
                 vram_write(6, 12, CMETEOR);
-                sprintf(mes, ": meteor (%d points)", METEOR_SCORE);
-                vram_strings(7, 12, mes);
+                vram_strings(7, 12, ": meteor (" HUD_STR(METEOR_SCORE) " points)");
                 vram_write(6, 14, CHEART);
-                sprintf(mes, ": heart (%d points)", HEART_SCORE);
-                vram_strings(7, 14, mes);
+                vram_strings(7, 14, ": heart (" HUD_STR(HEART_SCORE) " points)");
                 if (blink == true) {
                     vram_strings(10, 16, "Push A button ");
                 } else {
@@ -652,6 +756,8 @@ int main() {
                 }
             }
         }
+        // count a tick of the host benchmark
+        BENCH_TICK();
         countup++;
     }
 
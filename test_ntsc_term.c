@@ -0,0 +1,130 @@
+/**
+ * Test program for NTSC signal generation.
+ * Text modes of 40 and 64 columns by the PIO video engine (ntsc_video.h):
+ * a log of the temperature sensor is printed to the scrolling console
+ * (ntsc_console.h).
+ * Hold A button at power on for 64 columns, B button for 64 x 56 interlaced.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "ntsc_video.h"
+#include "ntsc_console.h"
+#include "hud.h"
+#define BENCH_TICKS 600 // frames of the host benchmark
+#include "bench.h"
+
+#define CONV_MVOLT  3300    // ADC data * CONV_MVOLT >> 12 -> voltage in mV (white Pico)
+#define TEMP_SLOPE  5950    // 1024 * 10 / 1.721 (0.1 degree per mV, Q10)
+#define ADC_TEMP    4       // temperature sensor input
+#define LED     25      // GPIO connected LED on the board
+#define MLED    (1 << LED)
+#define LEDON   gpio_put_masked(MLED, MLED)
+#define LEDOFF  gpio_put_masked(MLED, 0)
+#define AKEYGP  7       // A key GP7
+#define BKEYGP  6       // B key GP6
+#define LSTATUS 1       // line of status
+#define LLOG    3       // first line of log
+#define LOG_FRAMES  60  // frames per log line
+
+volatile bool state = true;
+
+// flip LED
+void flip_led( void ) {
+    if (state == true) {
+        LEDON;
+    } else {
+        LEDOFF;
+    }
+    state = !state;
+}
+
+// print a log line of the temperature sensor
+void log_temp( int sec ) {
+    uint16_t temp_dat;
+    int mvolt, temp10;
+    // read ADC(temperature) data
+    temp_dat = adc_read();
+    // convert ADC data to voltage (mV) and temperature (0.1 degree)
+    mvolt = (temp_dat * CONV_MVOLT) >> 12;
+    temp10 = 270 - (((mvolt - 706) * TEMP_SLOPE) >> 10);
+    // "    12 s  ADC  876  V 0.706  T  27.0"
+    printf("%6d s  ADC %4d  V %d.%03d  T %s%2d.%d", sec, temp_dat, mvolt / 1000, mvolt % 1000,
+        (temp10 < 0) ? "-" : " ", abs(temp10) / 10, abs(temp10) % 10);
+    // wide mode: frame counter too
+    if (ntsc_mode_now->cols >= 64) {
+        printf("   frame %8lu", (unsigned long)ntsc_frame);
+    }
+    printf("\n");
+}
+
+int main() {
+    // select NTSC, PAL or PAL-M by the strap pins (and set the system clock
+    // before the peripherals take their dividers from it)
+    video_timing_init();
+    // init stdio
+    stdio_init_all();
+    // init ADC
+    adc_init();
+    // enable temperature sensor
+    adc_set_temp_sensor_enabled(true);
+    // select ADC input
+    adc_select_input(ADC_TEMP);
+    // initialize LED GPIO
+    gpio_init(LED);
+    gpio_init_mask(MLED);
+    gpio_set_dir(LED, GPIO_OUT);
+    // initialize A key GPIO
+    gpio_init(AKEYGP);
+    gpio_set_dir(AKEYGP, GPIO_IN);
+    gpio_pull_up(AKEYGP);
+    // initialize B key GPIO
+    gpio_init(BKEYGP);
+    gpio_set_dir(BKEYGP, GPIO_IN);
+    gpio_pull_up(BKEYGP);
+
+    // select video mode by A or B button held at power on, and start video
+    const ntsc_mode *mode = &ntsc_text40;
+    if (gpio_get(AKEYGP) == 0) {
+        mode = &ntsc_text64;
+    } else if (gpio_get(BKEYGP) == 0) {
+        mode = &ntsc_text64i;
+    }
+    ntsc_video_init(mode);
+    // rows from LLOG are the console of stdio
+    con_init(LLOG);
+
+    hud_field hud_frame, hud_sec;
+    int sec = 0;
+
+    ntsc_text_strings(0, 0, "NTSC TERMINAL");
+    ntsc_text_strings(mode->cols - strlen(mode->name), 0, mode->name);
+    // system clock and sample clock divider: "125MHz DIV 15.62"
+    ntsc_text_strings(17, 0, "MHz DIV");
+    hud_number(14, 0, 3, 0, clock_get_hz(clk_sys) / 1000000, ntsc_text_write);
+    hud_number(25, 0, 5, 2, ntsc_clkdiv * 100 / 256, ntsc_text_write);
+    ntsc_text_strings(0, LSTATUS, "FRAME            UPTIME        s");
+    hud_init(&hud_frame, 6, LSTATUS, 8, ntsc_text_write);
+    hud_init(&hud_sec, 24, LSTATUS, 6, ntsc_text_write);
+
+    while (1) {
+        // draw once per frame
+        ntsc_wait_vblank();
+        hud_set(&hud_frame, ntsc_frame);
+        if (ntsc_frame % LOG_FRAMES == 0) {
+            // flip LED
+            flip_led();
+            sec++;
+            hud_set(&hud_sec, sec);
+            // the console scrolls the log when it reaches the bottom
+            log_temp(sec);
+        }
+        // count a tick of the host benchmark
+        BENCH_TICK();
+    }
+
+    return 0;
+}
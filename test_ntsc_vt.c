@@ -0,0 +1,96 @@
+/**
+ * Test program for NTSC signal generation.
+ * VT100 terminal by the PIO video engine (ntsc_video.h and ntsc_vt.h):
+ * the bytes received on GP1 (UART0 RX) at 921600 baud are shown from the
+ * third row, with the bytes received and lost on the status row.
+ * Hold A button at power on for 64 columns, B button for 64 x 56 interlaced.
+ * The host build reads the received bytes from the file named by NTSC_UART.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "ntsc_video.h"
+#include "ntsc_vt.h"
+#include "hud.h"
+#include "bench.h"
+
+#define LED     25      // GPIO connected LED on the board
+#define MLED    (1 << LED)
+#define LEDON   gpio_put_masked(MLED, MLED)
+#define LEDOFF  gpio_put_masked(MLED, 0)
+#define AKEYGP  7       // A key GP7
+#define BKEYGP  6       // B key GP6
+#define RXGP    1       // UART0 RX GP1
+#define LSTATUS 1       // line of status
+#define LTERM   2       // first line of the terminal
+
+volatile bool state = true;
+
+// flip LED
+void flip_led( void ) {
+    if (state == true) {
+        LEDON;
+    } else {
+        LEDOFF;
+    }
+    state = !state;
+}
+
+int main() {
+    // select NTSC, PAL or PAL-M by the strap pins (and set the system clock
+    // before the peripherals take their dividers from it)
+    video_timing_init();
+    // init stdio
+    stdio_init_all();
+    // initialize LED GPIO
+    gpio_init(LED);
+    gpio_init_mask(MLED);
+    gpio_set_dir(LED, GPIO_OUT);
+    // initialize A key GPIO
+    gpio_init(AKEYGP);
+    gpio_set_dir(AKEYGP, GPIO_IN);
+    gpio_pull_up(AKEYGP);
+    // initialize B key GPIO
+    gpio_init(BKEYGP);
+    gpio_set_dir(BKEYGP, GPIO_IN);
+    gpio_pull_up(BKEYGP);
+
+    // select video mode by A or B button held at power on, and start video
+    const ntsc_mode *mode = &ntsc_text40;
+    if (gpio_get(AKEYGP) == 0) {
+        mode = &ntsc_text64;
+    } else if (gpio_get(BKEYGP) == 0) {
+        mode = &ntsc_text64i;
+    }
+    ntsc_video_init(mode);
+    // rows from LTERM are the terminal of UART0
+    vt_init(uart0, VT_BAUD, RXGP, LTERM);
+
+    ntsc_text_strings(0, 0, "NTSC VT100 921600 BAUD");
+    ntsc_text_strings(mode->cols - strlen(mode->name), 0, mode->name);
+    ntsc_text_strings(0, LSTATUS, "RX            LOST");
+    hud_field hud_rx, hud_lost;
+    hud_init(&hud_rx, 3, LSTATUS, 10, ntsc_text_write);
+    hud_init(&hud_lost, 19, LSTATUS, 8, ntsc_text_write);
+
+    while (1) {
+        // parse what has arrived once per frame, within the vblank
+        ntsc_wait_vblank();
+        BENCH_BEGIN("vt_poll");
+        vt_poll();
+        BENCH_END("vt_poll");
+        if (ntsc_frame % 8 == 0) {
+            hud_set(&hud_rx, vt_tail);
+            hud_set(&hud_lost, vt_overruns);
+        }
+        if (ntsc_frame % 60 == 0) {
+            // flip LED
+            flip_led();
+        }
+        // count a tick of the host benchmark
+        BENCH_TICK();
+    }
+
+    return 0;
+}
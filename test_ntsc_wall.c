@@ -11,8 +11,15 @@
 #include "pico/stdlib.h"
 #include "hardware/irq.h"
 #include "hardware/pwm.h"
+#include "video_timing.h"     // NTSC, PAL and PAL-M
 #include "hardware/adc.h"
 #include "font8x8_basic.h"
+#include "font8x8_2bpp.h"     // generated by tools/fontgen
+#include "font8x8_2bpp_inv.h" // generated by tools/fontgen (black on white)
+#include "raster.h"
+#include "replay.h"
+#include "bench.h"
+#include "hud.h"
 
 #define LED     25      // GPIO connected LED on the board
 #define MLED    (1 << LED)
@@ -27,9 +34,10 @@
 #define WHITE   gpio_put_masked(M14 | M15, M14 | M15)     // GPIO14='H' and GPIO15='H'
 #define BLACK   gpio_put_masked(M14 | M15, M15)           // GPIO14='L' and GPIO15='H'
 #define GRAY    gpio_put_masked(M14 | M15, M14)           // GPIO14='H' and GPIO15='L'
+#define LEVEL(v)    gpio_put_masked(M14 | M15, (v) << GP14)   // 2-bit level code (GPIO15:GPIO14)
 #define VRAM_W  30      // width size of VRAM
 #define VRAM_H  28      // height size of VRAM
-#define V_BASE  24      // horizontal line number to start displaying VRAM
+#define V_BASE  (24 + video_v_shift)  // horizontal line number to start displaying VRAM (NTSC)
 
 #define RKEYGP  11      // Right key GP11
 #define UKEYGP  10      // Up key GP10
@@ -74,9 +82,13 @@
 #define HEART_BONUS 30  // bonus point for getting heart
 #define BASE_SCORE  10  // base score
 #define STAGE_BONUS 100 // base stage bonus
+#define HUD_CYCLES  200 // cycle budget of the raster handler of the HUD rows
 
-volatile unsigned char vram[VRAM_W][VRAM_H]; // VRAM
+volatile unsigned char vram[VRAM_H][VRAM_W]; // VRAM (row-major)
+#include "attr.h"     // attributes of VRAM (needs VRAM_W and VRAM_H)
+#include "vdma.h"     // VRAM clear and scroll by DMA
 volatile int count = 1;                      // horizontal line counter
+uint16_t (*text_font)[FONT8X8_2BPP_NUM] = font8x8_2bpp;   // pixel levels of the lines drawn
 volatile bool state = true;
 typedef struct {
     int x;          // x of entity
@@ -88,23 +100,21 @@ typedef struct {
     bool odd;       // true: draw new floor, false: draw empty floor
 } entity;
 
-// to clear VRAM contents (set to 0)
+// to clear VRAM contents (set to 0) and attributes by DMA
 void vram_clear( void ) {
-    for (int i = 0; i < VRAM_W; i++) {
-        for (int j = 0; j < VRAM_H; j++) {
-            vram[i][j] = 0;
-        }
-    }
+    vdma_fill(vram, 0, sizeof(vram));
+    vdma_fill(vram_attr, 0, sizeof(vram_attr));
+    vdma_wait();
 }
 
 // to write a value into VRAM located at (x, y)
 void vram_write ( int x, int y, unsigned char value ) {
-    vram[x][y] = value;
+    vram[y][x] = value;
 }
 
 // to read a value from VRAM located at (x, y)
 unsigned char vram_read( int x, int y) {
-    return vram[x][y];
+    return vram[y][x];
 }
 
 // to write strings into VRAM located at (x, y)
@@ -120,7 +130,7 @@ void vram_strings( int x, int y, char *mes) {
             return;
         // else put a character at the position
         } else {
-            vram[x + i][y] = mes[i];
+            vram[y][x + i] = mes[i];
         }
     }
     return;
@@ -186,7 +196,8 @@ uint32_t key_scan( ) {
     if (gpio_get(AKEYGP) == 0) result |= AKEY;
     if (gpio_get(BKEYGP) == 0) result |= BKEY;
 
-    return result;
+    // record or replay keys
+    return replay_keys(result);
 }
 
 // initialize mouse array
@@ -232,7 +243,7 @@ void draw_one_floor( int y ) {
     vram_write(ENDW, y, CWALL);
     // draw wall and hole
     for (int x = STARTW + 1; x < ENDW; x++) {
-        if ((rand() % 100) < 25) {
+        if ((replay_rand() % 100) < 25) {
             vram_write(x, y, ' ');
             count++;
         } else {
@@ -241,7 +252,7 @@ void draw_one_floor( int y ) {
     }
     // if there is no hole
     if (count == 0) {
-        vram_write(rand()%(ENDW - STARTW - 1) + STARTW + 1, y, ' ');
+        vram_write(replay_rand()%(ENDW - STARTW - 1) + STARTW + 1, y, ' ');
     }
 }
 
@@ -279,22 +290,24 @@ void move_entity( entity *e, int max_num, int threshold ) {
         // if the entity exists
         if (e[i].y < VRAM_H) {
             // if downward is empty
-            if ((vram[e[i].x][e[i].y + 1] != CWALL) && (vram[e[i].x][e[i].y + 1] != CGND)) {
+            // (below the bottom line is empty)
+            if ((e[i].y + 1 >= VRAM_H)
+                || ((vram[e[i].y + 1][e[i].x] != CWALL) && (vram[e[i].y + 1][e[i].x] != CGND))) {
                 e[i].y++;
                 e[i].sp = 0;
             } else {
                 // if rightward is a wall
-                if (vram[e[i].x + 1][e[i].y] == CWALL) {
+                if (vram[e[i].y][e[i].x + 1] == CWALL) {
                     e[i].x--;
                     e[i].sp = -1;
                 // if leftward is a wall
-                } else if (vram[e[i].x - 1][e[i].y] == CWALL) {
+                } else if (vram[e[i].y][e[i].x - 1] == CWALL) {
                     e[i].x++;
                     e[i].sp = +1;
                 // if rightward and leftward are both empty
                 } else {
                     if (e[i].sp == 0) {
-                        if ((rand() % 2) == 0) {
+                        if ((replay_rand() % 2) == 0) {
                             e[i].x++;
                             e[i].sp = +1;
                         } else {
@@ -309,17 +322,17 @@ void move_entity( entity *e, int max_num, int threshold ) {
         }
     }
     // generate new entity
-    if (rand() % 100 < threshold) {
+    if (replay_rand() % 100 < threshold) {
         // search disappeared entity position
         for (i = 0; i < max_num; i++) {
             if (e[i].y >= VRAM_H) break;
         }
         // if we can generate new entity
         if (i < max_num) {
-            e[i].x = rand() % (ENDW - STARTW) + STARTW;
+            e[i].x = replay_rand() % (ENDW - STARTW) + STARTW;
             e[i].y = LOXYGEN + 1;
-            while (vram[e[i].x][e[i].y] == CWALL) {
-                e[i].x = rand() % (ENDW - STARTW) + STARTW;
+            while (vram[e[i].y][e[i].x] == CWALL) {
+                e[i].x = replay_rand() % (ENDW - STARTW) + STARTW;
                 e[i].y = LOXYGEN + 1;
             }   
         }
@@ -333,6 +346,9 @@ void move_entity( entity *e, int max_num, int threshold ) {
     }
 }
 
+// move down floors (defined below)
+void move_down_floors( entity *mouse, entity *heart, bool draw_floor, int floor );
+
 // scan keys and move me
 bool move_me( entity *me, entity *mouse, entity *heart, int floor ) {
     uint32_t keys;
@@ -351,7 +367,7 @@ bool move_me( entity *me, entity *mouse, entity *heart, int floor ) {
     // move right
     if ((keys & RKEY) != 0) {
         if (me->x < ENDW - 1) {
-            if (vram[me->x + 1][me->y] != CWALL) {
+            if (vram[me->y][me->x + 1] != CWALL) {
                 me->x++;
             }
         }
@@ -359,7 +375,7 @@ bool move_me( entity *me, entity *mouse, entity *heart, int floor ) {
     // move left
     if ((keys & LKEY) != 0) {
         if (me->x > STARTW + 1) {
-            if (vram[me->x - 1][me->y] != CWALL) {
+            if (vram[me->y][me->x - 1] != CWALL) {
                 me->x--;
             }
         }
@@ -369,13 +385,17 @@ bool move_me( entity *me, entity *mouse, entity *heart, int floor ) {
         // if I am in super mode
         if ((me->sp == SUPERME) && (me->timer > 0)) {
             vram_write(me->x, me->y - 1, ' ');
+            BENCH_BEGIN("move_down_floors");
             move_down_floors(mouse, heart, me->odd, floor);
+            BENCH_END("move_down_floors");
             result = true;
             me->odd = !me->odd;
         }
         // if I am in normal mode
-        if (vram[me->x][me->y - 1] != CWALL) {
+        if (vram[me->y - 1][me->x] != CWALL) {
+            BENCH_BEGIN("move_down_floors");
             move_down_floors(mouse, heart, me->odd, floor);
+            BENCH_END("move_down_floors");
             result = true;
             me->odd = !me->odd;
         }
@@ -389,12 +409,9 @@ bool move_me( entity *me, entity *mouse, entity *heart, int floor ) {
 // move down floors
 void move_down_floors( entity *mouse, entity *heart, bool draw_floor, int floor ) {
     bool inner_draw_floor;
-    // scroll down floors
-    for (int y = VRAM_H - 2; y >= LOXYGEN + 1; y--) {
-        for (int x = STARTW; x <= ENDW; x++) {
-            vram[x][y + 1] = vram[x][y];
-        }
-    }
+    // scroll down floors (whole rows: the columns out of the walls are 0)
+    vdma_move(vram[LOXYGEN + 2], vram[LOXYGEN + 1], (VRAM_H - 2 - LOXYGEN) * VRAM_W);
+    vdma_wait();
     inner_draw_floor = draw_floor;
     // if near roof floor, not draw floor 
     if (floor > MAXFLOOR - 8) {
@@ -435,7 +452,7 @@ int judge_me( entity *me, entity *mouse, entity *heart) {
         if ((me->x == heart[i].x) && (me->y == heart[i].y)) {
             // normal me changed to super me
             me->sp = SUPERME;
-            me->timer = rand() % MYTIMER + MYTIMER;
+            me->timer = replay_rand() % MYTIMER + MYTIMER;
             // bonus point
             bonus = HEART_BONUS;
             // clear the heart
@@ -467,41 +484,38 @@ void init_random( ) {
         adc_select_input(i);
         seed_val += adc_read();
     }
-    srand(seed_val);
+    replay_srand(seed_val);
 }
 
 // to generate horizontal sync siganl
-void hsync( void ) {
+void __not_in_flash_func(hsync)( void ) {
     SYNC;
-    sleep_us(5);
+    video_wait_cycles(video_sync_cycles);
     BLACK;
-    sleep_us(7);
+    video_wait_cycles(video_porch_cycles);
 }
 
 // to generate vertical sync siganl
-void vsync ( void ) {
+void __not_in_flash_func(vsync)( void ) {
+    // two broad pulses of half a line, a serration of hsync width between
     SYNC;
-    sleep_us(10);
-    sleep_us(5);
-    sleep_us(10);
+    video_wait_cycles(video_broad_cycles);
     BLACK;
-    sleep_us(5);
+    video_wait_cycles(video_sync_cycles);
 
     SYNC;
-    sleep_us(10);
-    sleep_us(5);
-    sleep_us(10);
+    video_wait_cycles(video_broad_cycles);
     BLACK;
-    sleep_us(5);
+    // the second serration lasts until the next line interrupt
 }
 
 // handler for holizontal line processing
-void horizontal_line( ) {
+void __not_in_flash_func(horizontal_line)( ) {
     // Clear the interrupt flag that brought us here
     pwm_clear_irq(pwm_gpio_to_slice_num(GPPWM));
 
     // vertical synchronization duration
-    if (count >= 3 && count <= 5) {
+    if (count >= video_now->vsync_first && count <= video_now->vsync_last) {
         vsync();    // vertical SYNC
 
     // VRAM drawing area
@@ -509,28 +523,33 @@ void horizontal_line( ) {
         hsync();
         // left blank??
         BLACK;
-        sleep_us(0);    // should be tuned
+        video_wait_us(0);    // should be tuned
 
         // calculate VRAM y position from scan line number
         int y = (count - V_BASE) / CHAR_H;
-        int cline = count % CHAR_H;
+        int cline = (count - V_BASE) % CHAR_H;
+        // pixel levels of all characters for this line (normal, upper and
+        // lower half of double height) and styles of the attributes
+        const uint16_t *rows[ATTR_ROWS] = ATTR_LINE_ROWS(text_font, cline);
+        const attr_style *styles = attr_styles;
+        // characters of this text row and their attributes (contiguous)
+        const volatile unsigned char *text = vram[y];
+        const volatile unsigned char *attr = vram_attr[y];
         // horizontal VRAM drawing
         for (int x = 0; x < VRAM_W; x++) {
-            // read VRAM
-            volatile unsigned char c = vram[x][y];
-            // draw bit from character table (ascii_table)
+            // read VRAM and the pixel levels of the character with its attribute
+            unsigned char c = text[x];
+            const attr_style *s = &styles[attr[x]];
+            uint32_t pix = ATTR_PIX(rows, s, c);
+            // draw pixels from the levels
             for (int w = 0; w < CHAR_W; w++) {
-                if ((ascii_table[c][cline] & (1 << w)) != 0) {
-                    WHITE;
-                } else {
-                    volatile uint16_t tmp = 1;
-                    BLACK;
-                }
+                LEVEL(pix & 3);
+                pix >>= 2;
             }
         }
         // right blank??
         BLACK;
-        sleep_us(0);
+        video_wait_us(0);
     } else {
         hsync();
         BLACK;
@@ -538,26 +557,51 @@ void horizontal_line( ) {
     // count up scan line 
     count++;
     // if scan line reach to max
-    if (count > 262) {
+    if (count > video_now->lines) {
         count = 1;
+        // count a frame (blink of attributes)
+        attr_vsync();
     }
+    // raster handler of the next line
+    raster_run(count);
     return;
 }
 
+// raster handler: the HUD rows (score and oxygen) in black on white
+void __not_in_flash_func(hud_band)( int line ) {
+    text_font = (line == V_BASE + LSCORE * CHAR_H) ? font8x8_2bpp_inv : font8x8_2bpp;
+}
+
 int main() {
     // initialize video and LED GPIO
     init_video_and_led_GPIO();
+    // select NTSC, PAL or PAL-M by the strap pins (and set the system clock
+    // before the peripherals take their dividers from it)
+    video_timing_init();
     // init stdio
     stdio_init_all();
     // init ADC
     adc_init();
     // enable temperature sensor
     adc_set_temp_sensor_enabled(true);
-    // clear VRAM
+    // claim the DMA channel of VRAM operations
+    vdma_init(true);
+    // make the styles of attributes and clear VRAM
+    attr_init();
     vram_clear();
+    // initialize key GPIO
+    init_key_GPIO();
+    // select record or replay mode by keys held at power on
+    replay_init(key_scan());
     // initialize random seed
     init_random();
 
+    // HUD band: inverse from the score row to the end of the oxygen row
+    raster_init();
+    int hud = raster_add(hud_band, HUD_CYCLES);
+    raster_set(V_BASE + LSCORE * CHAR_H, hud);
+    raster_set(V_BASE + (LOXYGEN + 1) * CHAR_H, hud);
+
     // GPPWM pin is the PWM output
     gpio_set_function(GPPWM, GPIO_FUNC_PWM);
     // Figure out which slice we just connected to the GPPWM pin
@@ -572,28 +616,24 @@ int main() {
     irq_set_enabled(PWM_IRQ_WRAP, true); 
 
     // Set counter wrap value to generate PWM interrupt by this value
-    pwm_set_wrap(slice_num, 7999);
+    pwm_set_wrap(slice_num, video_pwm_wrap());
     // Load the configuration into our PWM slice, and set it running.
     pwm_set_enabled(slice_num, true);
 
-    // initialize key GPIO
-    init_key_GPIO();
-
     int countup = 0;
     int score = 0;
     int hi_score = 0;
     int mouse_rate = IMRATE;
     int p_mouse = IPMOUSE;
-    int oxygen;
+    int oxygen = 0;
     int bonus;
     int floor = 0;
-    int stages;
+    int stages = 0;
     int count_upstair = 0;
     int hp_up_score = HP_UP_SCORE;
     uint32_t keys;
-    bool blink = true;
     bool initial;
-    char mes[VRAM_W];
+    hud_field hud_score, hud_hi, hud_hp, hud_oxygen, hud_floor, hud_stage;
     entity me, mouse[NMOUSE], heart[NHEART];
     enum State {IDLE, PLAY, OVER, CLEAR} game_state;
 
@@ -642,6 +682,16 @@ int main() {
                 vram_clear();
                 // initialize stage
                 init_floors();
+                // draw HUD labels and fields
+                vram_strings(0, LSCORE, "SCORE       HiSCORE       HP");
+                vram_strings(0, LOXYGEN, "OXYGEN     FLOOR     STAGE");
+                hud_init(&hud_score, 5, LSCORE, 6, vram_write);
+                hud_init(&hud_hi, 19, LSCORE, 6, vram_write);
+                hud_init(&hud_hp, 28, LSCORE, 2, vram_write);
+                hud_init(&hud_oxygen, 6, LOXYGEN, 4, vram_write);
+                hud_init(&hud_floor, 16, LOXYGEN, 4, vram_write);
+                hud_init(&hud_stage, 26, LOXYGEN, 3, vram_write);
+                hud_set(&hud_hi, hi_score);
                 // clear initializing flag
                 initial = false;
             }
@@ -652,14 +702,18 @@ int main() {
             // my turn
             if (countup % MYRATE == 0) {
                 // move me
+                BENCH_BEGIN("move_me");
                 count_upstair += (move_me(&me, mouse, heart, floor) == true) ? 1 : 0;
+                BENCH_END("move_me");
                 if (count_upstair >= 2) {
                     count_upstair = 0;
                     score += stages * BASE_SCORE;
                     floor++;
                 }
                 // judge me (bump into mouse or get heart)
+                BENCH_BEGIN("judge_me");
                 score += judge_me(&me, mouse, heart) * stages;
+                BENCH_END("judge_me");
                 // if score is over hp_up_score
                 if (score >= hp_up_score) {
                     // HP++
@@ -671,6 +725,9 @@ int main() {
                 if ((me.hp <= 0) || (oxygen <= 0)) {
                     // game state is game over
                     game_state = OVER;
+                    // save recorded keys for replay and print them
+                    replay_save();
+                    replay_dump();
                 }
                 // if floor > MAXFLOOR
                 if (floor >= MAXFLOOR) {
@@ -678,20 +735,23 @@ int main() {
                     game_state = CLEAR;
                 }
                 // display score, hi-score and HP
-                sprintf(mes, "SCORE%6d HiSCORE%6d HP%2d", score, hi_score, me.hp);
-                vram_strings(0, LSCORE, mes);
-                sprintf(mes, "OXYGEN%4d FLOOR%4d STAGE%3d", oxygen, MAXFLOOR - floor, stages);
-                vram_strings(0, LOXYGEN, mes);
+                hud_set(&hud_score, score);
+                hud_set(&hud_hp, me.hp);
+                hud_set(&hud_oxygen, oxygen);
+                hud_set(&hud_floor, MAXFLOOR - floor);
+                hud_set(&hud_stage, stages);
                 if (me.sp == SUPERME) {
-                    vram[29][LOXYGEN] = CHEART;
+                    vram[LOXYGEN][29] = CHEART;
                 } else {
-                    vram[29][LOXYGEN] = ' ';
+                    vram[LOXYGEN][29] = ' ';
                 }
             }
             // mouse turn
             if (countup % mouse_rate == 0) {
                 // move mouse
+                BENCH_BEGIN("move_entity");
                 move_entity(mouse, NMOUSE, p_mouse);
+                BENCH_END("move_entity");
                 // change mouse rate
                 if (IMRATE - floor * 70 > MMRATE) {
                     mouse_rate = IMRATE - floor * 70;
@@ -705,7 +765,9 @@ int main() {
             // heart turn
             if (countup % HTRATE == 0) {
                 // move heart
+                BENCH_BEGIN("move_entity");
                 move_entity(heart, NHEART, PHEART);
+                BENCH_END("move_entity");
             }        
         }
         // clear, continue to play and add bonus score
@@ -715,18 +777,13 @@ int main() {
                 o_bonus = oxygen * BASE_SCORE * stages;
                 s_bonus = stages * STAGE_BONUS;
                 // stage clear title
-                vram_strings(10, 10, "STAGE CLEAR!");
+                attr_strings(3, 10, "STAGE CLEAR!", ATTR_DW);
                 bonus = o_bonus + s_bonus;
-                sprintf(mes, "OXYGEN BONUS: %4d", o_bonus);
-                vram_strings(6, 12, mes);
-                sprintf(mes, "STAGE  BONUS: %4d", s_bonus);
-                vram_strings(6, 14, mes);
-                if (blink == true) {
-                    vram_strings(9, 18, "Push B button ");
-                } else {
-                    vram_strings(9, 18, "              ");
-                }
-                blink = !blink;
+                vram_strings(6, 12, "OXYGEN BONUS: ");
+                hud_number(20, 12, 4, 0, o_bonus, vram_write);
+                vram_strings(6, 14, "STAGE  BONUS: ");
+                hud_number(20, 14, 4, 0, s_bonus, vram_write);
+                attr_strings(9, 18, "Push B button ", ATTR_BLINK);
             }
             if (countup % 200000) {
                 // scan keys
@@ -743,20 +800,15 @@ int main() {
         if (game_state == IDLE) {
             if (countup % 80000 == 0) {
                 // game title
-                vram_strings(7, 6, " DROPPING MONSTERS");
-                vram_strings(7, 8, "   by Pa@ART 2021 ");
-                vram[7][10] = CME; 
+                attr_strings(7, 6, " DROPPING MONSTERS", ATTR_DH);
+                attr_strings(7, 8, "   by Pa@ART 2021 ", ATTR_GRAY);
+                vram[10][7] = CME; 
                 vram_strings(8, 10, ": YOU (SPACEMAN) ");
-                vram[7][12] = CMOUSE; 
+                vram[12][7] = CMOUSE; 
                 vram_strings(8, 12, ": MONSTER MOUSE  ");
-                vram[7][14] = CHEART; 
+                vram[14][7] = CHEART; 
                 vram_strings(8, 14, ": POWER UP HEART ");
-                if (blink == true) {
-                    vram_strings(9, 18, "Push A button ");
-                } else {
-                    vram_strings(9, 18, "              ");
-                }
-                blink = !blink;
+                attr_strings(9, 18, "Push A button ", ATTR_BLINK);
             }
             if (countup % 200000 == 0) {
                 // scan keys
@@ -774,7 +826,7 @@ int main() {
         if (game_state == OVER) {
             if (countup % 80000 == 0) {
                 // game over title
-                vram_strings(10, 10, "GAME OVER!!");
+                attr_strings(10, 10, "GAME OVER!!", ATTR_INVERSE);
                 // if oxygen has exhausted
                 if (oxygen <= 0) {
                     vram_strings(10, 12, "Oxygen exhausted!");
@@ -784,12 +836,7 @@ int main() {
                     hi_score = score;
                     vram_strings(10, 14, "Hi-Score!!");
                 }
-                if (blink == true) {
-                    vram_strings(9, 18, "Push B button ");
-                } else {
-                    vram_strings(9, 18, "              ");
-                }
-                blink = !blink;
+                attr_strings(9, 18, "Push B button ", ATTR_BLINK);
             }
             if (countup % 200000) {
                 // scan keys
@@ -803,6 +850,8 @@ int main() {
                 }
             }
         }
+        // count a tick of the host benchmark
+        BENCH_TICK();
         countup++;
     }
 
@@ -12,8 +12,13 @@
 #include "pico/stdlib.h"
 #include "hardware/irq.h"
 #include "hardware/pwm.h"
+#include "video_timing.h"     // NTSC, PAL and PAL-M
 #include "hardware/adc.h"
 #include "font8x8_basic.h"
+#include "replay.h"
+#include "bench.h"
+#include "hud.h"
+#include "vdma.h"             // VRAM clear by DMA
 
 #define LED     25      // GPIO connected LED on the board
 #define MLED    (1 << LED)
@@ -28,14 +33,17 @@
 #define WHITE   gpio_put_masked(M14 | M15, M14 | M15)     // GPIO14='H' and GPIO15='H'
 #define BLACK   gpio_put_masked(M14 | M15, M15)           // GPIO14='L' and GPIO15='H'
 #define GRAY    gpio_put_masked(M14 | M15, M14)           // GPIO14='H' and GPIO15='L'
+#define LEVEL(v)    gpio_put_masked(M14 | M15, (v) << GP14)   // 2-bit level code (GPIO15:GPIO14)
 #define VRAM_W  32      // width size of VRAM
 #define VRAM_H  24      // height size of VRAM
 #define GVRAM_W (VRAM_W * CHAR_W)   // width size of graphic VRAM
 #define GVRAM_H (VRAM_H * CHAR_H)   // height size of graphic VRAM
-#define V_BASE  40      // horizontal line number to start displaying VRAM
-#define BDOT    0       // black dot
-#define WDOT    1       // white dot
-#define GDOT    2       // gray dot
+#define V_BASE  (40 + video_v_shift)  // horizontal line number to start displaying VRAM (NTSC)
+#define BDOT    2       // black dot (level code of GPIO15:GPIO14)
+#define WDOT    3       // white dot
+#define GDOT    1       // gray dot
+#define TILE_MODE       // composite tiles in scanline (else packed graphic VRAM)
+#define TGRAY   0x80    // tile offset of gray characters
 
 #define RKEYGP  11      // Right key GP11
 #define UKEYGP  10      // Up key GP10
@@ -81,8 +89,16 @@
 #define BASE_SCORE  10  // base score
 #define STAGE_BONUS 100 // base stage bonus
 
-volatile unsigned char gvram[GVRAM_W][GVRAM_H]; // graphic VRAM
-volatile unsigned char vram[VRAM_W][VRAM_H]; // character VRAM
+#ifdef TILE_MODE
+#define TMAP_W  VRAM_W
+#define TMAP_H  VRAM_H
+#include "tilemap.h"    // tile map and tile cache
+#else
+#include "gvram.h"      // packed graphic VRAM (needs GVRAM_W and GVRAM_H)
+#include "blit.h"       // word-at-a-time blitter
+#endif
+
+volatile unsigned char vram[VRAM_H][VRAM_W]; // character VRAM (row-major)
 volatile int count = 1;                      // horizontal line counter
 volatile bool state = true;
 typedef struct {
@@ -95,47 +111,50 @@ typedef struct {
     bool odd;       // true: draw new floor, false: draw empty floor
 } entity;
 
-// to clear VRAM contents (set to 0)
+// to clear VRAM contents (set to 0) by DMA
 void vram_clear( void ) {
-    for (int i = 0; i < VRAM_W; i++) {
-        for (int j = 0; j < VRAM_H; j++) {
-            vram[i][j] = 0;
-        }
-    }
-}
-
-// to clear graphical VRAM contents (set to 0)
-void gvram_clear( void ) {
-    for (int i = 0; i < GVRAM_W; i++) {
-        for (int j = 0; j < GVRAM_H; j++) {
-            gvram[i][j] = BDOT;
-        }
-    }
+    vdma_fill(vram, 0, sizeof(vram));
+    vdma_wait();
 }
 
 // to write a value into VRAM located at (x, y)
 void vram_write ( int x, int y, unsigned char value ) {
-    vram[x][y] = value;
+    vram[y][x] = value;
+}
+
+// to initialize the screen
+void screen_init( void ) {
+#ifdef TILE_MODE
+    // white and gray characters on black
+    tile_define_font(0, ascii_table[0], ASCII_CHAR_NUM, WDOT, BDOT);
+    tile_define_font(TGRAY, ascii_table[0], ASCII_CHAR_NUM, GDOT, BDOT);
+    tmap_clear(' ');
+#else
+    gvram_init();
+#endif
 }
 
-// to write a value into graphical VRAM located at (x, y)
-void gvram_write ( int x, int y, unsigned char value ) {
-    gvram[x][y] = value;
+// to clear the screen
+void screen_clear( void ) {
+#ifdef TILE_MODE
+    tmap_clear(' ');
+#else
+    gvram_clear(BDOT);
+#endif
 }
 
-// put a character on VRAM
+// put a character on VRAM (x and y are multiples of CHAR_W and CHAR_H in tile mode)
 void gvram_put_char( int x, int y, char c, char col ) {
-    unsigned char cp;
-    for (int i = 0; i < CHAR_H; i++) {
-        cp = ascii_table[c][i];
-        for (int j = 0; j < CHAR_W; j++) {
-            if ((cp & (1 << j)) != 0) {
-                gvram[x + j][y + i] = col;
-            } else {
-                gvram[x + j][y + i] = BDOT;
-            }
-        }
-    }
+#ifdef TILE_MODE
+    tmap[y / CHAR_H][x / CHAR_W] = (unsigned char)c | ((col == GDOT) ? TGRAY : 0);
+#else
+    blit_glyph(x, y, ascii_table[(unsigned char)c], CHAR_W, CHAR_H, col, BDOT);
+#endif
+}
+
+// put a character of HUD (x and y in characters)
+void hud_gput( int x, int y, unsigned char c ) {
+    gvram_put_char(x * CHAR_W, y * CHAR_H, c, WDOT);
 }
 
 // put strings on VRAM
@@ -144,15 +163,8 @@ void gvram_strings( int x, int y, char *mes, char col ) {
     if ((x < 0) || (x > GVRAM_W) || (y < 0) || (y > GVRAM_H)) {
         return;
     }
-    int l = strlen(mes);
-    for (int i = 0; i < l * CHAR_W; i += CHAR_W) {
-        // if x position overflows, return
-        if (x + i >= GVRAM_W) {
-            return;
-        // else put a character at the position
-        } else {
-            gvram_put_char(x + i, y, mes[i / CHAR_W], col);
-        }
+    for (; *mes != '\0' && x < GVRAM_W; mes++, x += CHAR_W) {
+        gvram_put_char(x, y, *mes, col);
     }
     return;
 }
@@ -217,7 +229,8 @@ uint32_t key_scan( ) {
     if (gpio_get(AKEYGP) == 0) result |= AKEY;
     if (gpio_get(BKEYGP) == 0) result |= BKEY;
 
-    return result;
+    // record or replay keys
+    return replay_keys(result);
 }
 
 // initialize mouse array
@@ -269,7 +282,7 @@ void draw_one_floor( int y ) {
     // draw wall and hole
     for (int x = STARTW + 1; x < ENDW; x++) {
         xx = x * CHAR_W;
-        if ((rand() % 100) < 25) {
+        if ((replay_rand() % 100) < 25) {
             vram_write(x, y, ' ');
             gvram_put_char(xx, yy, ' ', GDOT);
             count++;
@@ -280,8 +293,9 @@ void draw_one_floor( int y ) {
     }
     // if there is no hole
     if (count == 0) {
-        vram_write(rand()%(ENDW - STARTW - 1) + STARTW + 1, y, ' ');
-        gvram_put_char((rand()%(ENDW - STARTW - 1) + STARTW + 1) * CHAR_W, yy, ' ', GDOT);
+        int hole = replay_rand()%(ENDW - STARTW - 1) + STARTW + 1;
+        vram_write(hole, y, ' ');
+        gvram_put_char(hole * CHAR_W, yy, ' ', GDOT);
     }
 }
 
@@ -328,22 +342,24 @@ void move_entity( entity *e, int max_num, int threshold ) {
         // if the entity exists
         if (e[i].y < VRAM_H) {
             // if downward is empty
-            if ((vram[e[i].x][e[i].y + 1] != CWALL) && (vram[e[i].x][e[i].y + 1] != CGND)) {
+            // (below the bottom line is empty)
+            if ((e[i].y + 1 >= VRAM_H)
+                || ((vram[e[i].y + 1][e[i].x] != CWALL) && (vram[e[i].y + 1][e[i].x] != CGND))) {
                 e[i].y++;
                 e[i].sp = 0;
             } else {
                 // if rightward is a wall
-                if (vram[e[i].x + 1][e[i].y] == CWALL) {
+                if (vram[e[i].y][e[i].x + 1] == CWALL) {
                     e[i].x--;
                     e[i].sp = -1;
                 // if leftward is a wall
-                } else if (vram[e[i].x - 1][e[i].y] == CWALL) {
+                } else if (vram[e[i].y][e[i].x - 1] == CWALL) {
                     e[i].x++;
                     e[i].sp = +1;
                 // if rightward and leftward are both empty
                 } else {
                     if (e[i].sp == 0) {
-                        if ((rand() % 2) == 0) {
+                        if ((replay_rand() % 2) == 0) {
                             e[i].x++;
                             e[i].sp = +1;
                         } else {
@@ -358,17 +374,17 @@ void move_entity( entity *e, int max_num, int threshold ) {
         }
     }
     // generate new entity
-    if (rand() % 100 < threshold) {
+    if (replay_rand() % 100 < threshold) {
         // search disappeared entity position
         for (i = 0; i < max_num; i++) {
             if (e[i].y >= VRAM_H) break;
         }
         // if we can generate new entity
         if (i < max_num) {
-            e[i].x = rand() % (ENDW - STARTW) + STARTW;
+            e[i].x = replay_rand() % (ENDW - STARTW) + STARTW;
             e[i].y = LOXYGEN + 1;
-            while (vram[e[i].x][e[i].y] == CWALL) {
-                e[i].x = rand() % (ENDW - STARTW) + STARTW;
+            while (vram[e[i].y][e[i].x] == CWALL) {
+                e[i].x = replay_rand() % (ENDW - STARTW) + STARTW;
                 e[i].y = LOXYGEN + 1;
             }   
         }
@@ -383,6 +399,9 @@ void move_entity( entity *e, int max_num, int threshold ) {
     }
 }
 
+// move down floors (defined below)
+void move_down_floors( entity *mouse, entity *heart, bool draw_floor, int floor );
+
 // scan keys and move me
 bool move_me( entity *me, entity *mouse, entity *heart, int floor ) {
     uint32_t keys;
@@ -402,7 +421,7 @@ bool move_me( entity *me, entity *mouse, entity *heart, int floor ) {
     // move right
     if ((keys & RKEY) != 0) {
         if (me->x < ENDW - 1) {
-            if (vram[me->x + 1][me->y] != CWALL) {
+            if (vram[me->y][me->x + 1] != CWALL) {
                 me->x++;
             }
         }
@@ -410,7 +429,7 @@ bool move_me( entity *me, entity *mouse, entity *heart, int floor ) {
     // move left
     if ((keys & LKEY) != 0) {
         if (me->x > STARTW + 1) {
-            if (vram[me->x - 1][me->y] != CWALL) {
+            if (vram[me->y][me->x - 1] != CWALL) {
                 me->x--;
             }
         }
@@ -421,13 +440,17 @@ bool move_me( entity *me, entity *mouse, entity *heart, int floor ) {
         if ((me->sp == SUPERME) && (me->timer > 0)) {
             vram_write(me->x, me->y - 1, ' ');
             gvram_put_char(me->x * CHAR_W, (me->y - 1) * CHAR_H, ' ', WDOT);
+            BENCH_BEGIN("move_down_floors");
             move_down_floors(mouse, heart, me->odd, floor);
+            BENCH_END("move_down_floors");
             result = true;
             me->odd = !me->odd;
         }
         // if I am in normal mode
-        if (vram[me->x][me->y - 1] != CWALL) {
+        if (vram[me->y - 1][me->x] != CWALL) {
+            BENCH_BEGIN("move_down_floors");
             move_down_floors(mouse, heart, me->odd, floor);
+            BENCH_END("move_down_floors");
             result = true;
             me->odd = !me->odd;
         }
@@ -444,20 +467,15 @@ void move_down_floors( entity *mouse, entity *heart, bool draw_floor, int floor
     bool inner_draw_floor;
     // scroll down floors
     for (int y = VRAM_H - 2; y >= LOXYGEN + 1; y--) {
-        for (int x = STARTW; x <= ENDW; x++) {
-            vram[x][y + 1] = vram[x][y];
-        }
-    }
-    for (int y = LOXYGEN; y < VRAM_H; y++) {
-        for (int x = STARTW; x <= ENDW; x++) {
-            int c = vram[x][y];
-            if (c == CWALL) {
-                gvram_put_char(x * CHAR_W, y * CHAR_H, c, GDOT);
-            } else {
-                gvram_put_char(x * CHAR_W, y * CHAR_H, c, WDOT);
-            }
-        }
-    }
+        memmove((void *)&vram[y + 1][STARTW], (void *)&vram[y][STARTW], ENDW - STARTW + 1);
+    }
+    // scroll down the picture of floors by a character
+#ifdef TILE_MODE
+    tmap_copy(STARTW, LOXYGEN + 2, STARTW, LOXYGEN + 1, ENDW - STARTW + 1, VRAM_H - LOXYGEN - 2);
+#else
+    blit_copy(STARTW * CHAR_W, (LOXYGEN + 2) * CHAR_H, STARTW * CHAR_W, (LOXYGEN + 1) * CHAR_H,
+              (ENDW - STARTW + 1) * CHAR_W, (VRAM_H - LOXYGEN - 2) * CHAR_H);
+#endif
     inner_draw_floor = draw_floor;
     // if near roof floor, not draw floor 
     if (floor > MAXFLOOR - 8) {
@@ -501,7 +519,7 @@ int judge_me( entity *me, entity *mouse, entity *heart) {
         if ((me->x == heart[i].x) && (me->y == heart[i].y)) {
             // normal me changed to super me
             me->sp = SUPERME;
-            me->timer = rand() % MYTIMER + MYTIMER;
+            me->timer = replay_rand() % MYTIMER + MYTIMER;
             // bonus point
             bonus = HEART_BONUS;
             // clear the heart
@@ -535,41 +553,38 @@ void init_random( ) {
         adc_select_input(i);
         seed_val += adc_read();
     }
-    srand(seed_val);
+    replay_srand(seed_val);
 }
 
 // to generate horizontal sync siganl
-void hsync( void ) {
+void __not_in_flash_func(hsync)( void ) {
     SYNC;
-    sleep_us(5);
+    video_wait_cycles(video_sync_cycles);
     BLACK;
-    sleep_us(7);
+    video_wait_cycles(video_porch_cycles);
 }
 
 // to generate vertical sync siganl
-void vsync ( void ) {
+void __not_in_flash_func(vsync)( void ) {
+    // two broad pulses of half a line, a serration of hsync width between
     SYNC;
-    sleep_us(10);
-    sleep_us(5);
-    sleep_us(10);
+    video_wait_cycles(video_broad_cycles);
     BLACK;
-    sleep_us(5);
+    video_wait_cycles(video_sync_cycles);
 
     SYNC;
-    sleep_us(10);
-    sleep_us(5);
-    sleep_us(10);
+    video_wait_cycles(video_broad_cycles);
     BLACK;
-    sleep_us(5);
+    // the second serration lasts until the next line interrupt
 }
 
 // handler for holizontal line processing
-void horizontal_line( ) {
+void __not_in_flash_func(horizontal_line)( ) {
     // Clear the interrupt flag that brought us here
     pwm_clear_irq(pwm_gpio_to_slice_num(GPPWM));
 
     // vertical synchronization duration
-    if (count >= 3 && count <= 5) {
+    if (count >= video_now->vsync_first && count <= video_now->vsync_last) {
         vsync();    // vertical SYNC
 
     // VRAM drawing area
@@ -577,28 +592,34 @@ void horizontal_line( ) {
         hsync();
         // left blank??
         BLACK;
-        sleep_us(0);    // should be tuned
+        video_wait_us(0);    // should be tuned
 
         int y = count - V_BASE;
-        for (int x = 0; x < GVRAM_W; x++) {
-            int c = gvram[x][y];
-            switch (c) {
-                case BDOT:  // black
-                BLACK;
-                break;
-                case WDOT:  // white
-                WHITE;
-                break;
-                case GDOT:  // gray
-                GRAY;
-                break;
-                default:
-                BLACK;
+#ifdef TILE_MODE
+        // expanded row of each tile on this line (8 level codes)
+        const uint16_t *row = tile_cache[y % TILE_H];
+        const unsigned char *map = tmap[y / TILE_H];
+        for (int x = 0; x < TMAP_W; x++) {
+            uint32_t pix = row[map[x]];
+            for (int w = 0; w < TILE_W; w++) {
+                LEVEL(pix & 3);
+                pix >>= 2;
+            }
+        }
+#else
+        // packed pixels of this line (16 level codes per word)
+        uint32_t *line = gvram[y];
+        for (int i = 0; i < GVRAM_WORDS; i++) {
+            uint32_t pix = line[i];
+            for (int w = 0; w < GV_PPW; w++) {
+                LEVEL(pix & 3);
+                pix >>= 2;
             }
         }
+#endif
         // right blank??
         BLACK;
-        sleep_us(0);
+        video_wait_us(0);
     } else {
         hsync();
         BLACK;
@@ -606,7 +627,7 @@ void horizontal_line( ) {
     // count up scan line 
     count++;
     // if scan line reach to max
-    if (count > 262) {
+    if (count > video_now->lines) {
         count = 1;
     }
     return;
@@ -615,14 +636,24 @@ void horizontal_line( ) {
 int main() {
     // initialize video and LED GPIO
     init_video_and_led_GPIO();
+    // select NTSC, PAL or PAL-M by the strap pins (and set the system clock
+    // before the peripherals take their dividers from it)
+    video_timing_init();
     // init stdio
     stdio_init_all();
     // init ADC
     adc_init();
     // enable temperature sensor
     adc_set_temp_sensor_enabled(true);
+    // claim the DMA channel of VRAM operations
+    vdma_init(true);
     // clear VRAM
     vram_clear();
+    screen_init();
+    // initialize key GPIO
+    init_key_GPIO();
+    // select record or replay mode by keys held at power on
+    replay_init(key_scan());
     // initialize random seed
     init_random();
 
@@ -640,28 +671,25 @@ int main() {
     irq_set_enabled(PWM_IRQ_WRAP, true); 
 
     // Set counter wrap value to generate PWM interrupt by this value
-    pwm_set_wrap(slice_num, 7999);
+    pwm_set_wrap(slice_num, video_pwm_wrap());
     // Load the configuration into our PWM slice, and set it running.
     pwm_set_enabled(slice_num, true);
 
-    // initialize key GPIO
-    init_key_GPIO();
-
     int countup = 0;
     int score = 0;
     int hi_score = 0;
     int mouse_rate = IMRATE;
     int p_mouse = IPMOUSE;
-    int oxygen;
+    int oxygen = 0;
     int bonus;
     int floor = 0;
-    int stages;
+    int stages = 0;
     int count_upstair = 0;
     int hp_up_score = HP_UP_SCORE;
     uint32_t keys;
     bool blink = true;
     bool initial;
-    char mes[VRAM_W];
+    hud_field hud_score, hud_hi, hud_hp, hud_oxygen, hud_floor, hud_stage;
     entity me, mouse[NMOUSE], heart[NHEART];
     enum State {IDLE, PLAY, OVER, CLEAR} game_state;
 
@@ -709,9 +737,19 @@ int main() {
                 // clear VRAM
                 vram_clear();
                 // clear graphical VRAM
-                gvram_clear();
+                screen_clear();
                 // initialize stage
                 init_floors();
+                // draw HUD labels and fields
+                gvram_strings(0, LSCORE * CHAR_H, "SCORE       HiSCORE       HP", WDOT);
+                gvram_strings(0, LOXYGEN * CHAR_H, "OXYGEN     FLOOR     STAGE", WDOT);
+                hud_init(&hud_score, 5, LSCORE, 6, hud_gput);
+                hud_init(&hud_hi, 19, LSCORE, 6, hud_gput);
+                hud_init(&hud_hp, 28, LSCORE, 2, hud_gput);
+                hud_init(&hud_oxygen, 6, LOXYGEN, 4, hud_gput);
+                hud_init(&hud_floor, 16, LOXYGEN, 4, hud_gput);
+                hud_init(&hud_stage, 26, LOXYGEN, 3, hud_gput);
+                hud_set(&hud_hi, hi_score);
                 // clear initializing flag
                 initial = false;
             }
@@ -722,14 +760,18 @@ int main() {
             // my turn
             if (countup % MYRATE == 0) {
                 // move me
+                BENCH_BEGIN("move_me");
                 count_upstair += (move_me(&me, mouse, heart, floor) == true) ? 1 : 0;
+                BENCH_END("move_me");
                 if (count_upstair >= 2) {
                     count_upstair = 0;
                     score += stages * BASE_SCORE;
                     floor++;
                 }
                 // judge me (bump into mouse or get heart)
+                BENCH_BEGIN("judge_me");
                 score += judge_me(&me, mouse, heart) * stages;
+                BENCH_END("judge_me");
                 // if score is over hp_up_score
                 if (score >= hp_up_score) {
                     // HP++
@@ -741,6 +783,9 @@ int main() {
                 if ((me.hp <= 0) || (oxygen <= 0)) {
                     // game state is game over
                     game_state = OVER;
+                    // save recorded keys for replay and print them
+                    replay_save();
+                    replay_dump();
                 }
                 // if floor > MAXFLOOR
                 if (floor >= MAXFLOOR) {
@@ -748,10 +793,11 @@ int main() {
                     game_state = CLEAR;
                 }
                 // display score, hi-score and HP
-                sprintf(mes, "SCORE%6d HiSCORE%6d HP%2d", score, hi_score, me.hp);
-                gvram_strings(0, LSCORE * CHAR_H, mes, WDOT);
-                sprintf(mes, "OXYGEN%4d FLOOR%4d STAGE%3d", oxygen, MAXFLOOR - floor, stages);
-                gvram_strings(0, LOXYGEN * CHAR_H, mes, WDOT);
+                hud_set(&hud_score, score);
+                hud_set(&hud_hp, me.hp);
+                hud_set(&hud_oxygen, oxygen);
+                hud_set(&hud_floor, MAXFLOOR - floor);
+                hud_set(&hud_stage, stages);
                 if (me.sp == SUPERME) {
                     gvram_put_char(29 * CHAR_W, LOXYGEN * CHAR_H, CHEART, WDOT);
                 } else {
@@ -761,7 +807,9 @@ int main() {
             // mouse turn
             if (countup % mouse_rate == 0) {
                 // move mouse
+                BENCH_BEGIN("move_entity");
                 move_entity(mouse, NMOUSE, p_mouse);
+                BENCH_END("move_entity");
                 // change mouse rate
                 if (IMRATE - floor * 70 > MMRATE) {
                     mouse_rate = IMRATE - floor * 70;
@@ -775,7 +823,9 @@ int main() {
             // heart turn
             if (countup % HTRATE == 0) {
                 // move heart
+                BENCH_BEGIN("move_entity");
                 move_entity(heart, NHEART, PHEART);
+                BENCH_END("move_entity");
             }        
         }
         // clear, continue to play and add bonus score
@@ -787,10 +837,10 @@ int main() {
                 // stage clear title
                 gvram_strings(10 * CHAR_W, 10 * CHAR_H, "STAGE CLEAR!", WDOT);
                 bonus = o_bonus + s_bonus;
-                sprintf(mes, "OXYGEN BONUS: %4d", o_bonus);
-                gvram_strings(6 * CHAR_W, 12 * CHAR_H, mes, WDOT);
-                sprintf(mes, "STAGE  BONUS: %4d", s_bonus);
-                gvram_strings(6 * CHAR_W, 14 * CHAR_H, mes, WDOT);
+                gvram_strings(6 * CHAR_W, 12 * CHAR_H, "OXYGEN BONUS: ", WDOT);
+                hud_number(20, 12, 4, 0, o_bonus, hud_gput);
+                gvram_strings(6 * CHAR_W, 14 * CHAR_H, "STAGE  BONUS: ", WDOT);
+                hud_number(20, 14, 4, 0, s_bonus, hud_gput);
                 if (blink == true) {
                     gvram_strings(9 * CHAR_W, 18 * CHAR_H, "Push B button ", WDOT);
                 } else {
@@ -871,10 +921,12 @@ int main() {
                     // clear VRAM
                     vram_clear();
                     // clear graphical VRAM
-                    gvram_clear();
+                    screen_clear();
                 }
             }
         }
+        // count a tick of the host benchmark
+        BENCH_TICK();
         countup++;
     }
 
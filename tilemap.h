@@ -0,0 +1,101 @@
+/**
+ * Tile map mode for the NTSC programs.
+ *
+ * The screen is a map of tile indices, tmap[y][x], composited during the
+ * scanline from a tile cache: each tile is kept as pre-expanded 2bpp rows
+ * (16 bits for 8 pixels, level codes of its own palette) in line-major
+ * order, so a scanline does one map read and one cache read per 8 pixels,
+ * like the text mode.  A 32x24 map takes 768 bytes and the cache of 256
+ * tiles 4KB, instead of 12KB (packed) or 48KB (a byte per pixel) of
+ * graphic VRAM, and a map update is a single byte write.
+ *
+ *   tile_define_font(0, ascii_table[0], 128, GV_WHITE, GV_BLACK);
+ *   tile_define_font(0x80, ascii_table[0], 128, GV_GRAY, GV_BLACK);
+ *   tmap[y][x] = 'A' | 0x80;      // gray 'A'
+ *
+ * Pixel values are the level codes of gvram.h (GV_BLACK, GV_GRAY, GV_WHITE).
+ * Define TMAP_W and TMAP_H (in tiles) before including this file.
+ */
+
+#ifndef __TILEMAP__
+#define __TILEMAP__
+
+#include <stdint.h>
+#include <string.h>
+
+#define TILE_W      8       // width of a tile
+#define TILE_H      8       // height of a tile
+#define TILE_NUM    256     // number of tiles
+
+unsigned char tmap[TMAP_H][TMAP_W];         // tile map (tile index per cell)
+uint16_t tile_cache[TILE_H][TILE_NUM];      // expanded rows of tiles, line-major
+const unsigned char *tile_pattern[TILE_NUM];    // 1bpp rows of tiles (bit 0 = leftmost)
+unsigned char tile_fg[TILE_NUM];            // palette of tiles (level codes)
+unsigned char tile_bg[TILE_NUM];
+
+// to expand the pattern of tile t into the cache with its palette
+void tile_expand( int t ) {
+    for (int i = 0; i < TILE_H; i++) {
+        unsigned char bits = (tile_pattern[t] != NULL) ? tile_pattern[t][i] : 0;
+        uint16_t pix = 0;
+        for (int j = 0; j < TILE_W; j++) {
+            pix |= (((bits >> j) & 1) ? tile_fg[t] : tile_bg[t]) << (j * 2);
+        }
+        tile_cache[i][t] = pix;
+    }
+}
+
+// to define tile t by TILE_H rows of pattern and a palette
+void tile_define( int t, const unsigned char *rows, int fg, int bg ) {
+    tile_pattern[t] = rows;
+    tile_fg[t] = fg;
+    tile_bg[t] = bg;
+    tile_expand(t);
+}
+
+// to change the palette of tile t
+void tile_palette( int t, int fg, int bg ) {
+    tile_fg[t] = fg;
+    tile_bg[t] = bg;
+    tile_expand(t);
+}
+
+// to define num tiles from t by a font of TILE_H bytes per character
+void tile_define_font( int t, const unsigned char *font, int num, int fg, int bg ) {
+    for (int i = 0; i < num && t + i < TILE_NUM; i++) {
+        tile_define(t + i, &font[i * TILE_H], fg, bg);
+    }
+}
+
+// to fill the map with tile t
+void tmap_clear( int t ) {
+    memset(tmap, t, sizeof(tmap));
+}
+
+// to put strings on the map (tiles are characters plus offset)
+void tmap_strings( int x, int y, const char *mes, int offset ) {
+    if ((y < 0) || (y >= TMAP_H)) {
+        return;
+    }
+    for (; *mes != '\0' && x < TMAP_W; mes++, x++) {
+        if (x >= 0) {
+            tmap[y][x] = (unsigned char)*mes + offset;
+        }
+    }
+}
+
+// to copy w x h cells from (sx, sy) to (dx, dy) (both on the map); areas may overlap
+void tmap_copy( int dx, int dy, int sx, int sy, int w, int h ) {
+    // copy rows bottom up when moving down
+    if (dy > sy) {
+        for (int i = h - 1; i >= 0; i--) {
+            memmove(&tmap[dy + i][dx], &tmap[sy + i][sx], w);
+        }
+    } else {
+        for (int i = 0; i < h; i++) {
+            memmove(&tmap[dy + i][dx], &tmap[sy + i][sx], w);
+        }
+    }
+}
+
+#endif
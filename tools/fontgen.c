@@ -0,0 +1,323 @@
+/**
+ * Font compiler for the NTSC programs (runs on the build host).
+ *
+ * Reads a bitmap font and writes a C header with a line-major table
+ * (table[line][character]) expanded for a video mode, so that the scanline
+ * code does a single table lookup per character per line.
+ *
+ * Input formats:
+ *   .h   C array like font8x8_basic.h ({ row, row, ... } per character,
+ *        bit 0 = leftmost pixel)
+ *   .bdf BDF bitmap font
+ *   .psf PC screen font (PSF1 / PSF2)
+ *
+ * Output modes (-m):
+ *   bits    glyph rows as they are (bit 0 = leftmost pixel)
+ *   2bpp    2-bit level code per pixel, leftmost pixel in bits 1:0
+ *   2bpp-dw 2bpp with every pixel doubled (double width)
+ *   pio     2bpp with leftmost pixel in bits 31:30 (PIO shifting left)
+ *
+ * Level codes are the GPIO15:GPIO14 states: 0=SYNC, 1=GRAY, 2=BLACK, 3=WHITE.
+ *
+ * usage: fontgen [-m mode] [-n name] [-w width] [-c count] [-f fg] [-b bg]
+ *                [-r] [-o output] input
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <ctype.h>
+
+#define MAX_GLYPH   512     // max number of characters
+#define MAX_H       32      // max height of a character
+#define MAX_W       16      // max width of a character
+
+typedef struct {
+    int w;                          // width of a character
+    int h;                          // height of a character
+    int num;                        // number of characters
+    uint32_t row[MAX_GLYPH][MAX_H]; // glyph rows, bit 0 = leftmost pixel
+    int width[MAX_GLYPH];           // advance width of each character
+} font;
+
+static font f;
+
+// reverse bit order of n bits (MSB-left -> bit 0 = leftmost)
+static uint32_t reverse_bits( uint32_t v, int n ) {
+    uint32_t r = 0;
+    for (int i = 0; i < n; i++) {
+        if (v & (1u << (n - 1 - i))) r |= 1u << i;
+    }
+    return r;
+}
+
+// read whole file
+static unsigned char *read_file( const char *path, long *size ) {
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) return NULL;
+    fseek(fp, 0, SEEK_END);
+    *size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    unsigned char *buf = malloc(*size + 1);
+    if (fread(buf, 1, *size, fp) != (size_t)*size) {
+        fclose(fp);
+        free(buf);
+        return NULL;
+    }
+    buf[*size] = '\0';
+    fclose(fp);
+    return buf;
+}
+
+// load C array: each inner { } is a character, its numbers are the rows
+static int load_c_array( const char *text, int w ) {
+    const char *p = strchr(text, '=');
+    if (p == NULL || (p = strchr(p, '{')) == NULL) return -1;
+    p++;
+    f.w = w;
+    f.h = 0;
+    f.num = 0;
+    while (*p != '\0' && f.num < MAX_GLYPH) {
+        // skip comments
+        if (p[0] == '/' && p[1] == '/') {
+            while (*p != '\0' && *p != '\n') p++;
+            continue;
+        }
+        if (*p == '}') break;
+        if (*p != '{') {
+            p++;
+            continue;
+        }
+        // read rows of a character
+        int n = 0;
+        p++;
+        while (*p != '\0' && *p != '}') {
+            if (isdigit((unsigned char)*p)) {
+                char *e;
+                unsigned long v = strtoul(p, &e, 0);
+                if (n < MAX_H) f.row[f.num][n++] = v;
+                p = e;
+            } else {
+                p++;
+            }
+        }
+        if (f.h == 0) f.h = n;
+        f.width[f.num] = w;
+        f.num++;
+        if (*p == '}') p++;
+    }
+    return (f.num > 0 && f.h > 0) ? 0 : -1;
+}
+
+// load BDF font
+static int load_bdf( const char *text ) {
+    int fbw = 0, fbh = 0, fbx = 0, fby = 0;
+    int enc = -1, bw = 0, bh = 0, bx = 0, by = 0, dw = 0;
+    const char *p = text;
+    f.num = 0;
+    while (*p != '\0') {
+        char line[256];
+        int l = 0;
+        while (*p != '\0' && *p != '\n' && l < 255) line[l++] = *p++;
+        line[l] = '\0';
+        if (*p == '\n') p++;
+        if (sscanf(line, "FONTBOUNDINGBOX %d %d %d %d", &fbw, &fbh, &fbx, &fby) == 4) {
+            f.w = fbw;
+            f.h = fbh;
+        } else if (sscanf(line, "ENCODING %d", &enc) == 1) {
+            dw = fbw;
+        } else if (sscanf(line, "DWIDTH %d", &dw) == 1) {
+        } else if (sscanf(line, "BBX %d %d %d %d", &bw, &bh, &bx, &by) == 4) {
+        } else if (strncmp(line, "BITMAP", 6) == 0) {
+            // rows of the character from top (bits are MSB-left)
+            int top = (fbh + fby) - (bh + by);
+            int left = bx - fbx;
+            int bytes = (bw + 7) / 8;
+            for (int i = 0; i < bh; i++) {
+                unsigned long v = strtoul(p, NULL, 16);
+                while (*p != '\0' && *p != '\n') p++;
+                if (*p == '\n') p++;
+                if (enc < 0 || enc >= MAX_GLYPH || top + i < 0 || top + i >= MAX_H) continue;
+                uint32_t r = reverse_bits(v, bytes * 8);
+                f.row[enc][top + i] |= (left >= 0) ? r << left : r >> -left;
+            }
+            if (enc >= 0 && enc < MAX_GLYPH) {
+                f.width[enc] = dw;
+                if (enc + 1 > f.num) f.num = enc + 1;
+            }
+        }
+    }
+    return (f.num > 0 && f.w > 0 && f.w <= MAX_W && f.h <= MAX_H) ? 0 : -1;
+}
+
+// load PSF1 or PSF2 font
+static int load_psf( const unsigned char *buf, long size ) {
+    const unsigned char *glyphs;
+    int bytes;
+    if (size >= 4 && buf[0] == 0x36 && buf[1] == 0x04) {
+        f.num = (buf[2] & 1) ? 512 : 256;
+        f.w = 8;
+        f.h = buf[3];
+        glyphs = buf + 4;
+    } else if (size >= 32 && buf[0] == 0x72 && buf[1] == 0xb5 && buf[2] == 0x4a && buf[3] == 0x86) {
+        uint32_t hdr[8];
+        memcpy(hdr, buf, sizeof(hdr));
+        glyphs = buf + hdr[2];
+        f.num = hdr[4];
+        f.h = hdr[6];
+        f.w = hdr[7];
+    } else {
+        return -1;
+    }
+    if (f.num > MAX_GLYPH) f.num = MAX_GLYPH;
+    if (f.w > MAX_W || f.h > MAX_H) return -1;
+    bytes = (f.w + 7) / 8;
+    if (glyphs + (long)f.num * f.h * bytes > buf + size) return -1;
+    for (int c = 0; c < f.num; c++) {
+        for (int i = 0; i < f.h; i++) {
+            uint32_t v = 0;
+            for (int b = 0; b < bytes; b++) {
+                v = (v << 8) | glyphs[(c * f.h + i) * bytes + b];
+            }
+            f.row[c][i] = reverse_bits(v >> (bytes * 8 - f.w), f.w);
+        }
+        f.width[c] = f.w;
+    }
+    return 0;
+}
+
+// expand a glyph row into level codes
+static uint32_t expand_row( uint32_t bits, int w, int dup, int fg, int bg, int msb ) {
+    uint32_t v = 0;
+    int n = 0;
+    for (int x = 0; x < w; x++) {
+        int level = (bits & (1u << x)) ? fg : bg;
+        for (int d = 0; d < dup; d++, n++) {
+            if (msb) {
+                v |= (uint32_t)level << (30 - n * 2);
+            } else {
+                v |= (uint32_t)level << (n * 2);
+            }
+        }
+    }
+    return v;
+}
+
+static void usage( void ) {
+    fprintf(stderr, "usage: fontgen [-m bits|2bpp|2bpp-dw|pio] [-n name] [-w width] [-c count]\n"
+        "               [-f fg] [-b bg] [-r] [-o output] input\n");
+    exit(1);
+}
+
+int main( int argc, char **argv ) {
+    const char *mode = "2bpp";
+    const char *name = NULL;
+    const char *output = NULL;
+    const char *input = NULL;
+    int w = 8, count = 128, fg = 3, bg = 2, ram = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] == '-' && argv[i][1] != '\0' && argv[i][2] == '\0') {
+            char opt = argv[i][1];
+            if (opt == 'r') {
+                ram = 1;
+                continue;
+            }
+            if (i + 1 >= argc) usage();
+            char *val = argv[++i];
+            switch (opt) {
+                case 'm': mode = val; break;
+                case 'n': name = val; break;
+                case 'o': output = val; break;
+                case 'w': w = atoi(val); break;
+                case 'c': count = atoi(val); break;
+                case 'f': fg = atoi(val) & 3; break;
+                case 'b': bg = atoi(val) & 3; break;
+                default: usage();
+            }
+        } else {
+            input = argv[i];
+        }
+    }
+    if (input == NULL || name == NULL) usage();
+
+    // load font
+    long size;
+    unsigned char *buf = read_file(input, &size);
+    if (buf == NULL) {
+        fprintf(stderr, "fontgen: can't read %s\n", input);
+        return 1;
+    }
+    const char *ext = strrchr(input, '.');
+    int err;
+    if (ext != NULL && strcmp(ext, ".bdf") == 0) {
+        err = load_bdf((const char *)buf);
+    } else if (ext != NULL && strcmp(ext, ".psf") == 0) {
+        err = load_psf(buf, size);
+    } else {
+        err = load_c_array((const char *)buf, w);
+    }
+    free(buf);
+    if (err != 0) {
+        fprintf(stderr, "fontgen: can't load font from %s\n", input);
+        return 1;
+    }
+    if (count > f.num) count = f.num;
+
+    // output format
+    int dup = 1, msb = 0, expand = 1;
+    if (strcmp(mode, "bits") == 0) {
+        expand = 0;
+    } else if (strcmp(mode, "2bpp-dw") == 0) {
+        dup = 2;
+    } else if (strcmp(mode, "pio") == 0) {
+        msb = 1;
+    } else if (strcmp(mode, "2bpp") != 0) {
+        usage();
+    }
+    int bits = expand ? f.w * dup * 2 : f.w;
+    if (bits > 32) {
+        fprintf(stderr, "fontgen: %d bits per row don't fit in a word\n", bits);
+        return 1;
+    }
+    const char *type = (bits <= 8) ? "uint8_t" : (bits <= 16 && !msb) ? "uint16_t" : "uint32_t";
+    int digits = (bits <= 8) ? 2 : (bits <= 16 && !msb) ? 4 : 8;
+
+    FILE *fp = (output != NULL) ? fopen(output, "w") : stdout;
+    if (fp == NULL) {
+        fprintf(stderr, "fontgen: can't write %s\n", output);
+        return 1;
+    }
+    char guard[64];
+    int l;
+    for (l = 0; name[l] != '\0' && l < 60; l++) guard[l] = toupper((unsigned char)name[l]);
+    guard[l] = '\0';
+
+    fprintf(fp, "// %s: generated by fontgen -m %s from %s, do not edit\n", name, mode, input);
+    fprintf(fp, "#ifndef __%s__\n#define __%s__\n\n#include <stdint.h>\n\n", guard, guard);
+    fprintf(fp, "#define %s_W      %d      // width of a character [pixels]\n", guard, f.w);
+    fprintf(fp, "#define %s_H      %d      // height of a character\n", guard, f.h);
+    fprintf(fp, "#define %s_NUM    %d     // number of characters\n", guard, count);
+    fprintf(fp, "#define %s_BITS   %d     // bits per row of a character\n\n", guard, bits);
+    fprintf(fp, "// %s[line][character]\n", name);
+    fprintf(fp, "%s%s %s[%d][%d] = {\n", ram ? "" : "const ", type, name, f.h, count);
+    for (int i = 0; i < f.h; i++) {
+        fprintf(fp, "    {   // line %d", i);
+        for (int c = 0; c < count; c++) {
+            uint32_t v = expand ? expand_row(f.row[c][i], f.w, dup, fg, bg, msb) : f.row[c][i];
+            fprintf(fp, "%s0x%0*X,", (c % 8 == 0) ? "\n        " : " ", digits, v);
+        }
+        fprintf(fp, "\n    },\n");
+    }
+    fprintf(fp, "};\n\n");
+    // advance width of each character (proportional fonts)
+    fprintf(fp, "// advance width of each character\n");
+    fprintf(fp, "const uint8_t %s_width[%d] = {", name, count);
+    for (int c = 0; c < count; c++) {
+        fprintf(fp, "%s%d,", (c % 16 == 0) ? "\n    " : " ", f.width[c]);
+    }
+    fprintf(fp, "\n};\n\n#endif\n");
+    if (fp != stdout) fclose(fp);
+    return 0;
+}
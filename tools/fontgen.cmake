@@ -0,0 +1,39 @@
+# Builds the fontgen host tool and provides
+#
+#   ntsc_generate_font(<target> <name> <mode> <input> [fontgen options...])
+#
+# which generates <name>.h (table <name>[line][character]) from a font file at
+# build time and adds it to the include path of <target>.
+
+if (NOT DEFINED FONTGEN_EXECUTABLE)
+    if (CMAKE_CROSSCOMPILING)
+        # build for the host, not for the Pico
+        include(ExternalProject)
+        ExternalProject_Add(fontgen_build
+                SOURCE_DIR ${CMAKE_CURRENT_LIST_DIR}
+                BINARY_DIR ${CMAKE_BINARY_DIR}/fontgen
+                CMAKE_ARGS "-DCMAKE_MAKE_PROGRAM:FILEPATH=${CMAKE_MAKE_PROGRAM}"
+                BUILD_BYPRODUCTS ${CMAKE_BINARY_DIR}/fontgen/fontgen ${CMAKE_BINARY_DIR}/fontgen/ramcheck
+                INSTALL_COMMAND ""
+                )
+        set(FONTGEN_EXECUTABLE ${CMAKE_BINARY_DIR}/fontgen/fontgen)
+        set(FONTGEN_DEPENDS fontgen_build)
+    else()
+        add_subdirectory(${CMAKE_CURRENT_LIST_DIR} ${CMAKE_BINARY_DIR}/tools)
+        set(FONTGEN_EXECUTABLE $<TARGET_FILE:fontgen>)
+        set(FONTGEN_DEPENDS fontgen)
+    endif()
+endif()
+
+function(ntsc_generate_font TARGET NAME MODE INPUT)
+    set(OUT_DIR ${CMAKE_CURRENT_BINARY_DIR}/generated/${TARGET})
+    add_custom_command(OUTPUT ${OUT_DIR}/${NAME}.h
+            COMMAND ${CMAKE_COMMAND} -E make_directory ${OUT_DIR}
+            COMMAND ${FONTGEN_EXECUTABLE} -m ${MODE} -n ${NAME} ${ARGN} -o ${OUT_DIR}/${NAME}.h ${INPUT}
+            DEPENDS ${FONTGEN_DEPENDS} ${INPUT}
+            VERBATIM
+            )
+    add_custom_target(${TARGET}_${NAME} DEPENDS ${OUT_DIR}/${NAME}.h)
+    add_dependencies(${TARGET} ${TARGET}_${NAME})
+    target_include_directories(${TARGET} PRIVATE ${OUT_DIR})
+endfunction()
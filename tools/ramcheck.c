@@ -0,0 +1,305 @@
+/**
+ * Flash check of the video interrupt for the NTSC programs (runs on the
+ * build host after linking).
+ *
+ * Walks the call graph of the given interrupt handlers in the disassembly
+ * of the ELF (objdump -d) and lists every function on it and every data
+ * object it reads (literal pool words, pc/rip-relative references) that
+ * lives in flash, with the chain of calls that reaches it.  Code and data
+ * in flash run through the XIP cache, so a miss delays the line; the hot
+ * path should be __not_in_flash_func() / __not_in_flash() (SRAM) instead.
+ * Calls through veneers and function addresses in literal pools are
+ * followed; ROM and peripheral addresses are ignored.
+ *
+ * usage: ramcheck [-d objdump] [-n nm] [-f lo-hi] [-e] elf root [root...]
+ *   -f  flash address range (default 10000000-1fffffff, XIP and its aliases)
+ *   -e  exit with 1 if anything is in flash (to fail the build)
+ *
+ * Calls through function pointers stored in RAM at run time can't be
+ * followed, so the functions the interrupt reaches through them are given
+ * as roots after the handler:
+ *   raster_add() handlers (raster.h)      e.g. hud_band of test_ntsc_wall
+ *   ntsc_vblank_func (ntsc_video.h)       con_vblank when con_init() is used
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <ctype.h>
+
+#define MAX_SYMS    16384
+#define MAX_FUNCS   8192
+#define MAX_REFS    64          // references kept per function
+#define MAX_LINE    1024
+
+typedef struct {
+    uint32_t addr, size;
+    char type;                  // nm type letter
+    char *name;
+} sym;
+
+typedef struct {
+    char *name;
+    uint32_t addr;
+    char *calls[MAX_REFS];      // functions called by name
+    int ncalls;
+    uint32_t refs[MAX_REFS];    // addresses referenced
+    int nrefs;
+    int parent;                 // caller on the walk (-1 for a root), -2 unvisited
+} func;
+
+static sym syms[MAX_SYMS];
+static int nsyms = 0;
+static func funcs[MAX_FUNCS];
+static int nfuncs = 0;
+static uint32_t flash_lo = 0x10000000, flash_hi = 0x1fffffff;
+
+static int in_flash( uint32_t a ) {
+    return a >= flash_lo && a <= flash_hi;
+}
+
+static int cmp_sym( const void *a, const void *b ) {
+    uint32_t x = ((const sym *)a)->addr, y = ((const sym *)b)->addr;
+    return (x > y) - (x < y);
+}
+
+// symbol containing address a (NULL if none)
+static sym *find_sym( uint32_t a ) {
+    int lo = 0, hi = nsyms - 1, best = -1;
+    while (lo <= hi) {
+        int m = (lo + hi) / 2;
+        if (syms[m].addr <= a) {
+            best = m;
+            lo = m + 1;
+        } else {
+            hi = m - 1;
+        }
+    }
+    if (best < 0) return NULL;
+    // the latest symbol starting at or before a which covers it
+    for (int i = best; i >= 0 && i > best - 8; i--) {
+        if (a >= syms[i].addr && a < syms[i].addr + (syms[i].size ? syms[i].size : 1)) {
+            return &syms[i];
+        }
+    }
+    return NULL;
+}
+
+static int find_func( const char *name ) {
+    for (int i = 0; i < nfuncs; i++) {
+        if (strcmp(funcs[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+static void add_call( func *f, const char *name ) {
+    for (int i = 0; i < f->ncalls; i++) {
+        if (strcmp(f->calls[i], name) == 0) return;
+    }
+    if (f->ncalls < MAX_REFS) f->calls[f->ncalls++] = strdup(name);
+}
+
+static void add_ref( func *f, uint32_t a ) {
+    for (int i = 0; i < f->nrefs; i++) {
+        if (f->refs[i] == a) return;
+    }
+    if (f->nrefs < MAX_REFS) f->refs[f->nrefs++] = a;
+}
+
+static FILE *run( const char *tool, const char *args, const char *elf ) {
+    char cmd[MAX_LINE];
+    snprintf(cmd, sizeof(cmd), "%s %s \"%s\"", tool, args, elf);
+    FILE *fp = popen(cmd, "r");
+    if (fp == NULL) {
+        fprintf(stderr, "ramcheck: cannot run %s\n", cmd);
+        exit(2);
+    }
+    return fp;
+}
+
+// nm -S: "addr [size] type name"
+static void load_syms( const char *nm, const char *elf ) {
+    FILE *fp = run(nm, "-S --defined-only", elf);
+    char line[MAX_LINE], name[MAX_LINE];
+    while (fgets(line, sizeof(line), fp) && nsyms < MAX_SYMS) {
+        unsigned long a, s;
+        char t;
+        if (sscanf(line, "%lx %lx %c %s", &a, &s, &t, name) == 4) {
+        } else if (sscanf(line, "%lx %c %s", &a, &t, name) == 3) {
+            s = 0;
+        } else {
+            continue;
+        }
+        syms[nsyms].addr = (uint32_t)a;
+        syms[nsyms].size = (uint32_t)s;
+        syms[nsyms].type = t;
+        syms[nsyms].name = strdup(name);
+        nsyms++;
+    }
+    pclose(fp);
+    qsort(syms, nsyms, sizeof(sym), cmp_sym);
+}
+
+// target of a call or jump: "bl 1000049c <sleep_us>" (not "<func+0x12>")
+static const char *call_target( const char *ins, char *name ) {
+    static const char *ops[] = { "bl", "blx", "b", "b.w", "b.n", "call", "jmp", NULL };
+    char op[32];
+    const char *p = ins;
+    while (*p && isspace((unsigned char)*p)) p++;
+    int n = 0;
+    while (p[n] && !isspace((unsigned char)p[n]) && n < 31) n++;
+    memcpy(op, p, n);
+    op[n] = '\0';
+    for (int i = 0; ops[i]; i++) {
+        if (strcmp(op, ops[i]) == 0) {
+            const char *l = strchr(p, '<'), *r = l ? strchr(l, '>') : NULL;
+            if (l == NULL || r == NULL || memchr(l, '+', r - l) != NULL) return NULL;
+            memcpy(name, l + 1, r - l - 1);
+            name[r - l - 1] = '\0';
+            return name;
+        }
+    }
+    return NULL;
+}
+
+// objdump -d: functions, their calls and referenced addresses
+static void load_disasm( const char *objdump, const char *elf ) {
+    FILE *fp = run(objdump, "-d --no-show-raw-insn", elf);
+    char line[MAX_LINE], name[MAX_LINE];
+    func *f = NULL;
+    while (fgets(line, sizeof(line), fp)) {
+        unsigned long a;
+        char hdr[MAX_LINE];
+        // "10000354 <horizontal_line>:"
+        if (sscanf(line, "%lx <%[^>]>:", &a, hdr) == 2 && strstr(line, ">:") != NULL) {
+            if (nfuncs >= MAX_FUNCS) break;
+            f = &funcs[nfuncs++];
+            memset(f, 0, sizeof(*f));
+            f->name = strdup(hdr);
+            f->addr = (uint32_t)a;
+            f->parent = -2;
+            // a veneer stands for the function it jumps to
+            size_t n = strlen(hdr);
+            if (strncmp(hdr, "__", 2) == 0 && n > 9 && strcmp(hdr + n - 7, "_veneer") == 0) {
+                hdr[n - 7] = '\0';
+                add_call(f, hdr + 2);
+            }
+            continue;
+        }
+        if (f == NULL) continue;
+        char *ins = strchr(line, ':');
+        if (ins == NULL) continue;
+        ins++;
+        if (call_target(ins, name) != NULL) {
+            add_call(f, name);
+        }
+        // literal pool word: ".word 0x20000c48"
+        char *w = strstr(ins, ".word");
+        if (w != NULL) {
+            add_ref(f, (uint32_t)strtoul(w + 5, NULL, 16));
+        }
+        // pc/rip-relative reference: "# 404040 <count>"
+        char *h = strchr(ins, '#');
+        if (h != NULL && strchr(h, '<') != NULL) {
+            add_ref(f, (uint32_t)strtoul(h + 1, NULL, 16));
+        }
+    }
+    pclose(fp);
+}
+
+static void print_chain( int i ) {
+    for (int p = funcs[i].parent; p >= 0; p = funcs[p].parent) {
+        printf(" <- %s", funcs[p].name);
+    }
+    printf("\n");
+}
+
+int main( int argc, char **argv ) {
+    const char *objdump = "arm-none-eabi-objdump", *nm = "arm-none-eabi-nm";
+    int strict = 0, i;
+    for (i = 1; i < argc && argv[i][0] == '-'; i++) {
+        if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            objdump = argv[++i];
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            nm = argv[++i];
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            unsigned long lo, hi;
+            if (sscanf(argv[++i], "%lx-%lx", &lo, &hi) == 2) {
+                flash_lo = (uint32_t)lo;
+                flash_hi = (uint32_t)hi;
+            }
+        } else if (strcmp(argv[i], "-e") == 0) {
+            strict = 1;
+        } else {
+            break;
+        }
+    }
+    if (argc - i < 2) {
+        fprintf(stderr, "usage: ramcheck [-d objdump] [-n nm] [-f lo-hi] [-e] elf root [root...]\n");
+        return 2;
+    }
+    const char *elf = argv[i++];
+    load_syms(nm, elf);
+    load_disasm(objdump, elf);
+
+    // walk the call graph from the roots (breadth first, for short chains)
+    int queue[MAX_FUNCS], head = 0, tail = 0;
+    for (; i < argc; i++) {
+        int r = find_func(argv[i]);
+        if (r < 0) {
+            printf("ramcheck: %s: no function %s\n", elf, argv[i]);
+            continue;
+        }
+        if (funcs[r].parent == -2) {
+            funcs[r].parent = -1;
+            queue[tail++] = r;
+        }
+    }
+    int nflash = 0, nvisit = 0;
+    char *seen_data[MAX_SYMS];
+    int nseen = 0;
+    while (head < tail) {
+        int c = queue[head++];
+        func *f = &funcs[c];
+        nvisit++;
+        if (in_flash(f->addr)) {
+            printf("  flash code: %s", f->name);
+            print_chain(c);
+            nflash++;
+        }
+        for (int k = 0; k < f->ncalls + f->nrefs; k++) {
+            int callee = -1;
+            if (k < f->ncalls) {
+                callee = find_func(f->calls[k]);
+            } else {
+                // address of a function (thumb bit cleared) or of data
+                uint32_t a = f->refs[k - f->ncalls];
+                sym *s = find_sym(a & ~1u);
+                if (s == NULL) continue;
+                if (strchr("tTwW", s->type) != NULL) {
+                    callee = find_func(s->name);
+                } else if (in_flash(a)) {
+                    int dup = 0;
+                    for (int j = 0; j < nseen; j++) dup |= (seen_data[j] == s->name);
+                    if (!dup && nseen < MAX_SYMS) {
+                        seen_data[nseen++] = s->name;
+                        printf("  flash data: %s (read by %s", s->name, f->name);
+                        for (int p = f->parent; p >= 0; p = funcs[p].parent) {
+                            printf(" <- %s", funcs[p].name);
+                        }
+                        printf(")\n");
+                        nflash++;
+                    }
+                    continue;
+                }
+            }
+            if (callee >= 0 && funcs[callee].parent == -2) {
+                funcs[callee].parent = c;
+                queue[tail++] = callee;
+            }
+        }
+    }
+    printf("ramcheck: %s: %d functions on the interrupt path, %d in flash\n", elf, nvisit, nflash);
+    return (strict && nflash > 0) ? 1 : 0;
+}
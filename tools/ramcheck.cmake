@@ -0,0 +1,32 @@
+# Provides
+#
+#   ntsc_ram_check(<target> <handler>...)
+#
+# which runs the ramcheck host tool on <target> after linking: it lists the
+# functions and data in flash on the call graph of the interrupt handlers
+# (see ramcheck.c).  With -DNTSC_RAM_CHECK_STRICT=ON anything in flash fails
+# the build.  Functions the interrupt calls through pointers set at run time
+# (raster_add() handlers, ntsc_vblank_func) are not found by the walk: list
+# them after the handler.  The tool is built with fontgen (fontgen.cmake).
+
+include(${CMAKE_CURRENT_LIST_DIR}/fontgen.cmake)
+
+option(NTSC_RAM_CHECK_STRICT "Fail the build if a video interrupt reaches flash" OFF)
+
+if (CMAKE_CROSSCOMPILING)
+    set(RAMCHECK_EXECUTABLE ${CMAKE_BINARY_DIR}/fontgen/ramcheck)
+else()
+    set(RAMCHECK_EXECUTABLE $<TARGET_FILE:ramcheck>)
+endif()
+
+function(ntsc_ram_check TARGET)
+    set(OPTIONS -d ${CMAKE_OBJDUMP} -n ${CMAKE_NM})
+    if (NTSC_RAM_CHECK_STRICT)
+        list(APPEND OPTIONS -e)
+    endif()
+    add_custom_command(TARGET ${TARGET} POST_BUILD
+            COMMAND ${RAMCHECK_EXECUTABLE} ${OPTIONS} $<TARGET_FILE:${TARGET}> ${ARGN}
+            VERBATIM
+            )
+    add_dependencies(${TARGET} ${FONTGEN_DEPENDS})
+endfunction()
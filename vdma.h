@@ -0,0 +1,161 @@
+/**
+ * Bulk VRAM operations by DMA: clear, fill, copy and row scroll of the text
+ * VRAM (bytes) and the packed graphic VRAM (gvram.h, words).
+ *
+ * An operation starts a transfer on a spare DMA channel and returns, so the
+ * CPU goes on with the game while the channel writes the VRAM; the next
+ * operation, or vdma_wait(), waits for it.  Transfers are words when the
+ * addresses and the length are multiples of 4, bytes otherwise.
+ *
+ *   vdma_init(true);
+ *   vdma_fill32(gvram[0], GV_FILL(GV_BLACK), GVRAM_H * GVRAM_WORDS);
+ *   move_balls();                   // runs while the VRAM is cleared
+ *   vdma_wait();
+ *   draw_balls();
+ *
+ * The channel of the video keeps the bus first: the PIO engine
+ * (ntsc_video.h) gives its channels high priority, and vdma_init(true)
+ * paces this channel by a DMA timer to a transfer every VDMA_PACE_Y /
+ * VDMA_PACE_X system clocks, leaving bus slots to the video, the line
+ * interrupt and the CPU.
+ *
+ * The DMA copies upwards in memory only, so a move to a higher address
+ * over its own source (a scroll down) is done from the end in parts as long
+ * as the distance, each clear of the source still to be moved, and waits
+ * for all but the last part; no buffer is needed.  A distance below
+ * VDMA_MOVE_MIN bytes, and every operation without a channel, is done by
+ * the CPU.
+ */
+
+#ifndef __VDMA__
+#define __VDMA__
+
+#include <string.h>
+#include "hardware/dma.h"
+
+#ifndef VDMA_MOVE_MIN
+#define VDMA_MOVE_MIN   16      // min distance of an overlapping move by DMA [bytes]
+#endif
+#ifndef VDMA_PACE_X
+#define VDMA_PACE_X     1       // transfers per VDMA_PACE_Y system clocks when paced
+#define VDMA_PACE_Y     2
+#endif
+
+int vdma_ch = -1;               // DMA channel, -1 if not claimed
+uint vdma_dreq = DREQ_FORCE;    // pacing of the channel
+uint32_t vdma_word;             // source of the running fill
+
+// to claim a DMA channel (and a DMA timer to pace it)
+void vdma_init( bool paced ) {
+    vdma_ch = dma_claim_unused_channel(false);
+    if (paced && vdma_ch >= 0) {
+        int t = dma_claim_unused_timer(false);
+        if (t >= 0) {
+            dma_timer_set_fraction(t, VDMA_PACE_X, VDMA_PACE_Y);
+            vdma_dreq = dma_get_timer_dreq(t);
+        }
+    }
+}
+
+// to wait for the end of the operation started last
+void vdma_wait( void ) {
+    if (vdma_ch >= 0) {
+        dma_channel_wait_for_finish_blocking(vdma_ch);
+    }
+}
+
+// true while an operation is running
+bool vdma_busy( void ) {
+    return vdma_ch >= 0 && dma_channel_is_busy(vdma_ch);
+}
+
+// to start a transfer of n bytes (read_inc false: fill with *src)
+void vdma_start( volatile void *dst, const volatile void *src, int n, bool read_inc ) {
+    uintptr_t a = (uintptr_t)dst | (read_inc ? (uintptr_t)src : 0) | (uintptr_t)n;
+    bool words = (a & 3) == 0;
+    dma_channel_config c = dma_channel_get_default_config(vdma_ch);
+    channel_config_set_transfer_data_size(&c, words ? DMA_SIZE_32 : DMA_SIZE_8);
+    channel_config_set_read_increment(&c, read_inc);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_dreq(&c, vdma_dreq);
+    dma_channel_configure(vdma_ch, &c, dst, src, words ? n / 4 : n, true);
+}
+
+// to fill n words from dst with v
+void vdma_fill32( volatile void *dst, uint32_t v, int n ) {
+    vdma_wait();
+    if (vdma_ch < 0) {
+        uint32_t *p = (uint32_t *)dst;
+        for (int i = 0; i < n; i++) {
+            p[i] = v;
+        }
+        return;
+    }
+    vdma_word = v;
+    vdma_start(dst, &vdma_word, n * 4, false);
+}
+
+// to fill n bytes from dst with v
+void vdma_fill( volatile void *dst, uint8_t v, int n ) {
+    vdma_wait();
+    if (vdma_ch < 0) {
+        memset((void *)dst, v, n);
+        return;
+    }
+    vdma_word = v * 0x01010101u;
+    vdma_start(dst, &vdma_word, n, false);
+}
+
+// to copy n bytes from src to dst (they may overlap by DMA only, with dst
+// below src; vdma_move() for any overlap)
+void vdma_copy( volatile void *dst, const volatile void *src, int n ) {
+    vdma_wait();
+    if (vdma_ch < 0) {
+        memcpy((void *)dst, (const void *)src, n);
+        return;
+    }
+    vdma_start(dst, src, n, true);
+}
+
+// to move n bytes from src to dst, which may overlap either way (not
+// inlined: GCC takes the memmove() of a known overlap for a memcpy())
+void __attribute__((noinline)) vdma_move( volatile void *dst, const volatile void *src, int n ) {
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+    intptr_t k = d - s;             // distance of a move upwards
+    if (vdma_ch < 0 || (k > 0 && k < n && k < VDMA_MOVE_MIN)) {
+        vdma_wait();
+        memmove(d, s, n);
+        return;
+    }
+    if (k <= 0 || k >= n) {
+        vdma_copy(dst, src, n);
+        return;
+    }
+    // upwards over the source: parts of k bytes from the end
+    while (n > k) {
+        n -= k;
+        vdma_wait();
+        vdma_start(d + n, s + n, k, true);
+    }
+    vdma_wait();
+    vdma_start(d, s, n, true);
+}
+
+// to scroll h rows of stride bytes from rows down (k > 0) or up (k < 0) by
+// |k| rows, filling the rows left behind with v
+void vdma_scroll( volatile void *rows, int stride, int h, int k, uint8_t v ) {
+    uint8_t *p = (uint8_t *)rows;
+    int m = (k < 0) ? -k : k;
+    if (m >= h) {
+        vdma_fill(p, v, h * stride);
+    } else if (k > 0) {
+        vdma_move(p + m * stride, p, (h - m) * stride);
+        vdma_fill(p, v, m * stride);
+    } else if (k < 0) {
+        vdma_move(p, p + m * stride, (h - m) * stride);
+        vdma_fill(p + (h - m) * stride, v, m * stride);
+    }
+}
+
+#endif
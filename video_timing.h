@@ -0,0 +1,200 @@
+/**
+ * Timing profiles of the video standards: NTSC (525/60), PAL (625/50) and
+ * PAL-M (525/60 with the PAL subcarrier).
+ *
+ * One firmware image runs on all of them: video_timing_init() selects the
+ * profile at power on from strap pins (VIDEO_PAL_GP or VIDEO_PALM_GP tied to
+ * GND; both open is NTSC), and the scanline code reads the line count,
+ * vertical sync and picture position from video_now instead of constants.
+ * Lines are numbered from 1 as in the standards (like count of the
+ * bit-banged programs).
+ *
+ *   video_timing_init();
+ *   pwm_set_wrap(slice_num, video_pwm_wrap());
+ *   ...
+ *   if (count > video_now->lines) count = 1;
+ *
+ * The host build selects the profile by the environment (NTSC_TIMING=pal
+ * or palm).
+ *
+ * The system clock can be raised for more compute per line: build with
+ * VIDEO_SYSCLK_MHZ=133, 200 or 250 (or 125) and video_timing_init() sets it
+ * (and the core voltage) from video_clocks[].  Nothing assumes 125 MHz: the
+ * PWM wrap of the line interrupt and the sample clock divider of the PIO
+ * engine are computed from clock_get_hz(clk_sys), and sync widths from the
+ * profile in ns: the bit-banged hsync() and vsync() wait the system clocks
+ * of video_sync_cycles and the others by video_wait_cycles().  The bit-banged scanlines get narrower pixels at higher
+ * clocks (room for wider VRAM), since their pixel is a gpio_put_masked().
+ *
+ * The line interrupts run from RAM (__not_in_flash_func()), so a flash
+ * access (XIP cache miss) can't delay a line: they wait by video_wait_us()
+ * instead of sleep_us(), and read only RAM tables.  tools/ramcheck lists
+ * whatever is left in flash on their call graph after linking.
+ */
+
+#ifndef __VIDEO_TIMING__
+#define __VIDEO_TIMING__
+
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/vreg.h"
+
+#define VIDEO_PAL_GP    20      // strap: GND for PAL
+#define VIDEO_PALM_GP   21      // strap: GND for PAL-M
+#ifndef VIDEO_SYSCLK_MHZ
+#define VIDEO_SYSCLK_MHZ    0   // system clock profile, 0 = as it is
+#endif
+#define VIDEO_H_START_NS    12000   // hsync and back porch of the bit-banged lines
+
+// half-line pulses of the lines of the vertical interval (interlaced)
+#define VIDEO_VL_EQ         0   // two equalizing pulses
+#define VIDEO_VL_BROAD      1   // two broad (serrated vsync) pulses
+#define VIDEO_VL_EQ_BROAD   2   // equalizing, then broad
+#define VIDEO_VL_BROAD_EQ   3   // broad, then equalizing
+#define VIDEO_VL_EQ_NONE    4   // equalizing, then no pulse
+#define VIDEO_VL_H_EQ       5   // horizontal sync, then equalizing
+#define VIDEO_VL_NUM        6
+
+typedef struct { short first, last, vl; } video_vlines;
+
+typedef struct {
+    const char *name;
+    int lines;                  // lines of a progressive frame
+    int lines_i;                // lines of an interlaced frame (two fields)
+    int field_i;                // line at the middle of which the second field starts
+    int field2_upper;           // 1: lines of the second field are above those of the first
+    int line_ns;                // line period [ns]
+    int sync_ns;                // horizontal sync
+    int eq_ns;                  // equalizing pulse
+    int vsync_first;            // lines of vertical sync (progressive)
+    int vsync_last;
+    int v_top;                  // first line of the picture area (of a field)
+    int v_visible;              // lines of the picture area
+    uint32_t fsc_hz;            // colour subcarrier
+    const video_vlines *vlines; // vertical interval of an interlaced frame
+    int vlines_num;
+} video_timing;
+
+// the tables are not const: they stay in RAM, as the line interrupts read
+// them on every line (flash goes through the XIP cache)
+video_vlines video_vlines_525[] = {
+    {1, 3, VIDEO_VL_EQ}, {4, 6, VIDEO_VL_BROAD}, {7, 9, VIDEO_VL_EQ},
+    {263, 263, VIDEO_VL_H_EQ}, {264, 265, VIDEO_VL_EQ}, {266, 266, VIDEO_VL_EQ_BROAD},
+    {267, 268, VIDEO_VL_BROAD}, {269, 269, VIDEO_VL_BROAD_EQ}, {270, 271, VIDEO_VL_EQ},
+    {272, 272, VIDEO_VL_EQ_NONE}
+};
+video_vlines video_vlines_625[] = {
+    {1, 2, VIDEO_VL_BROAD}, {3, 3, VIDEO_VL_BROAD_EQ}, {4, 5, VIDEO_VL_EQ},
+    {311, 312, VIDEO_VL_EQ}, {313, 313, VIDEO_VL_EQ_BROAD}, {314, 315, VIDEO_VL_BROAD},
+    {316, 317, VIDEO_VL_EQ}, {318, 318, VIDEO_VL_EQ_NONE},
+    {623, 623, VIDEO_VL_H_EQ}, {624, 625, VIDEO_VL_EQ}
+};
+#define VIDEO_VLINES(v) v, (int)(sizeof(v) / sizeof(v[0]))
+
+video_timing video_ntsc = {
+    "NTSC", 262, 525, 263, 1, 63556, 4700, 2300, 3, 5, 29, 224, 3579545,
+    VIDEO_VLINES(video_vlines_525)
+};
+video_timing video_pal = {
+    "PAL", 312, 625, 313, 0, 64000, 4700, 2350, 3, 5, 31, 272, 4433619,
+    VIDEO_VLINES(video_vlines_625)
+};
+video_timing video_palm = {
+    "PAL-M", 262, 525, 263, 1, 63556, 4700, 2300, 3, 5, 29, 224, 3575611,
+    VIDEO_VLINES(video_vlines_525)
+};
+
+// system clock profiles: PLL VCO and post dividers, core voltage
+typedef struct { int mhz; uint32_t vco_hz; uint8_t pd1, pd2; enum vreg_voltage vreg; } video_clock;
+
+const video_clock video_clocks[] = {
+    {125, 1500000000, 6, 2, VREG_VOLTAGE_DEFAULT},
+    {133, 1596000000, 6, 2, VREG_VOLTAGE_DEFAULT},
+    {200, 1200000000, 6, 1, VREG_VOLTAGE_DEFAULT},
+    {250, 1500000000, 6, 1, VREG_VOLTAGE_1_15}
+};
+
+const video_timing *video_now = &video_ntsc;    // selected profile
+int video_v_shift = 0;          // lines the picture moves down from NTSC
+// pulses of the bit-banged lines in system clocks (set by video_timing_select())
+uint32_t video_sync_cycles;     // horizontal sync, serration of vsync
+uint32_t video_porch_cycles;    // black from the end of hsync to VIDEO_H_START_NS
+uint32_t video_broad_cycles;    // broad pulse of vsync (half a line less a serration)
+
+// system clocks of ns at the present clock
+#define VIDEO_NS_CYCLES(ns) ((uint32_t)((uint64_t)clock_get_hz(clk_sys) * (ns) / 1000000000))
+
+// to select a profile (after the system clock is set)
+void video_timing_select( const video_timing *t ) {
+    video_now = t;
+    video_v_shift = (t->v_top + t->v_visible / 2) - (video_ntsc.v_top + video_ntsc.v_visible / 2);
+    video_sync_cycles = VIDEO_NS_CYCLES(t->sync_ns);
+    video_porch_cycles = VIDEO_NS_CYCLES(VIDEO_H_START_NS - t->sync_ns);
+    video_broad_cycles = VIDEO_NS_CYCLES(t->line_ns / 2 - t->sync_ns);
+}
+
+// to set the system clock of a profile in MHz; false if there is no such profile
+bool video_clock_init( int mhz ) {
+    for (int i = 0; i < (int)(sizeof(video_clocks) / sizeof(video_clocks[0])); i++) {
+        const video_clock *c = &video_clocks[i];
+        if (c->mhz != mhz) {
+            continue;
+        }
+        // raise the voltage before the clock
+        vreg_set_voltage(c->vreg);
+        sleep_ms(1);
+        return set_sys_clock_pll(c->vco_hz, c->pd1, c->pd2);
+    }
+    return false;
+}
+
+// to set the system clock (VIDEO_SYSCLK_MHZ) and select the profile by the
+// strap pins (or NTSC_TIMING on the host)
+void video_timing_init( void ) {
+    if (VIDEO_SYSCLK_MHZ != 0) {
+        video_clock_init(VIDEO_SYSCLK_MHZ);
+    }
+#ifdef NTSC_HOST
+    const char *s = getenv("NTSC_TIMING");
+    bool pal = (s != NULL && strcmp(s, "pal") == 0);
+    bool palm = (s != NULL && strcmp(s, "palm") == 0);
+#else
+    gpio_init(VIDEO_PAL_GP);
+    gpio_set_dir(VIDEO_PAL_GP, GPIO_IN);
+    gpio_pull_up(VIDEO_PAL_GP);
+    gpio_init(VIDEO_PALM_GP);
+    gpio_set_dir(VIDEO_PALM_GP, GPIO_IN);
+    gpio_pull_up(VIDEO_PALM_GP);
+    sleep_us(10);
+    bool pal = (gpio_get(VIDEO_PAL_GP) == 0);
+    bool palm = (gpio_get(VIDEO_PALM_GP) == 0);
+#endif
+    video_timing_select(pal ? &video_pal : (palm ? &video_palm : &video_ntsc));
+}
+
+// to wait in a line interrupt: sleep_us() runs from flash through the alarm
+// code, this spins on the raw timer from RAM
+void __not_in_flash_func(video_wait_us)( uint32_t us ) {
+#ifdef NTSC_HOST
+    sleep_us(us);
+#else
+    uint32_t start = timer_hw->timerawl;
+    while (timer_hw->timerawl - start < us) {
+        tight_loop_contents();
+    }
+#endif
+}
+
+// to wait system clocks in a line interrupt (from RAM)
+void __not_in_flash_func(video_wait_cycles)( uint32_t cycles ) {
+    busy_wait_at_least_cycles(cycles);
+}
+
+// PWM wrap of a line period at the system clock (the line interrupt)
+uint16_t video_pwm_wrap( void ) {
+    return (uint64_t)clock_get_hz(clk_sys) * video_now->line_ns / 1000000000 - 1;
+}
+
+#endif